@@ -38,9 +38,10 @@ public:
     }
 
     constexpr size_t GetNextSet(size_t n) const {
-        for (size_t i = (n + 1) / FlagsPerWord; i < NumWords; i++) {
+        const size_t first_word = (n + 1) / FlagsPerWord;
+        for (size_t i = first_word; i < NumWords; i++) {
             Storage word = this->words[i];
-            if (!IsAligned(n + 1, FlagsPerWord)) {
+            if (i == first_word && !IsAligned(n + 1, FlagsPerWord)) {
                 word &= GetBitMask(n % FlagsPerWord) - 1;
             }
             if (word) {
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+/**
+ * Read-only memory mapping of the contents of a file at the time it was mapped.
+ * Data written to the file after mapping it may or may not be visible through the mapping.
+ */
+class MappedFile {
+public:
+    MappedFile();
+
+    /**
+     * Maps the file at path.
+     *
+     * @param path Filesystem path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    SUYU_NON_COPYABLE(MappedFile);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Maps the file at path, unmapping the currently mapped file if any.
+     * Empty files can't be mapped.
+     *
+     * @param path Filesystem path
+     */
+    void Open(const std::filesystem::path& path);
+
+    /// Unmaps the currently mapped file.
+    void Close();
+
+    /// Returns true if a file is mapped.
+    [[nodiscard]] bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    /// Returns the mapped contents of the file.
+    [[nodiscard]] std::span<const u8> Data() const {
+        return {data, size};
+    }
+
+private:
+    const u8* data{};
+    size_t size{};
+};
+
+} // namespace Common::FS
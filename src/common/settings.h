@@ -62,6 +62,7 @@ SWITCHABLE(AntiAliasing, false);
 SWITCHABLE(AspectRatio, true);
 SWITCHABLE(AstcDecodeMode, true);
 SWITCHABLE(AstcRecompression, true);
+SWITCHABLE(Bc7Quality, true);
 SWITCHABLE(AudioMode, true);
 SWITCHABLE(CpuBackend, true);
 SWITCHABLE(CpuAccuracy, true);
@@ -193,6 +194,7 @@ struct Values {
 
     // Core
     SwitchableSetting<bool> use_multi_core{linkage, true, "use_multi_core", Category::Core};
+    Setting<bool> use_service_executor{linkage, false, "use_service_executor", Category::Core};
     SwitchableSetting<MemoryLayout, true> memory_layout_mode{linkage,
                                                              MemoryLayout::Memory_4Gb,
                                                              MemoryLayout::Memory_4Gb,
@@ -277,6 +279,8 @@ struct Values {
 
     SwitchableSetting<bool> use_disk_shader_cache{linkage, true, "use_disk_shader_cache",
                                                   Category::Renderer};
+    SwitchableSetting<bool> use_disk_texture_cache{linkage, false, "use_disk_texture_cache",
+                                                   Category::Renderer};
     SwitchableSetting<bool> use_asynchronous_gpu_emulation{
         linkage, true, "use_asynchronous_gpu_emulation", Category::Renderer};
     SwitchableSetting<AstcDecodeMode, true> accelerate_astc{linkage,
@@ -382,15 +386,39 @@ struct Values {
     SwitchableSetting<AstcRecompression, true> astc_recompression{linkage,
                                                                   AstcRecompression::Uncompressed,
                                                                   AstcRecompression::Uncompressed,
-                                                                  AstcRecompression::Bc3,
+                                                                  AstcRecompression::Bc7,
                                                                   "astc_recompression",
                                                                   Category::RendererAdvanced};
+    SwitchableSetting<Bc7Quality, true> bc7_quality{linkage,
+                                                    Bc7Quality::Medium,
+                                                    Bc7Quality::Fast,
+                                                    Bc7Quality::High,
+                                                    "bc7_quality",
+                                                    Category::RendererAdvanced};
     SwitchableSetting<VramUsageMode, true> vram_usage_mode{linkage,
                                                            VramUsageMode::Conservative,
                                                            VramUsageMode::Conservative,
                                                            VramUsageMode::Aggressive,
                                                            "vram_usage_mode",
                                                            Category::RendererAdvanced};
+    SwitchableSetting<u32, true> vram_budget{linkage,
+                                             0,
+                                             0,
+                                             65536,
+                                             "vram_budget",
+                                             Category::RendererAdvanced,
+                                             Specialization::Countable,
+                                             true,
+                                             false};
+    SwitchableSetting<u32, true> query_result_latency{linkage,
+                                                      0,
+                                                      0,
+                                                      8,
+                                                      "query_result_latency",
+                                                      Category::RendererAdvanced,
+                                                      Specialization::Countable,
+                                                      true,
+                                                      false};
     SwitchableSetting<bool> async_presentation{linkage,
 #ifdef ANDROID
                                                true,
@@ -590,11 +618,15 @@ struct Values {
     Setting<bool> quest_flag{linkage, false, "quest_flag", Category::Debugging};
     Setting<bool> disable_macro_jit{linkage, false, "disable_macro_jit",
                                     Category::DebuggingGraphics};
+    Setting<bool> enable_arm64_macro_jit{linkage, false, "enable_arm64_macro_jit",
+                                         Category::DebuggingGraphics};
     Setting<bool> disable_macro_hle{linkage, false, "disable_macro_hle",
                                     Category::DebuggingGraphics};
     Setting<bool> extended_logging{
         linkage, false, "extended_logging", Category::Debugging, Specialization::Default, false};
     Setting<bool> use_debug_asserts{linkage, false, "use_debug_asserts", Category::Debugging};
+    Setting<bool> profile_scheduler_lock{linkage, false, "profile_scheduler_lock",
+                                         Category::Debugging};
     Setting<bool> use_auto_stub{
         linkage, false, "use_auto_stub", Category::Debugging, Specialization::Default, false};
     Setting<bool> enable_all_controllers{linkage, false, "enable_all_controllers",
@@ -630,9 +630,7 @@ std::span<GPUDirtyMemoryManager> System::GetGPUDirtyMemoryManager() {
 }
 
 void System::GatherGPUDirtyMemory(std::function<void(PAddr, size_t)>& callback) {
-    for (auto& manager : impl->gpu_dirty_memory_managers) {
-        manager.Gather(callback);
-    }
+    GPUDirtyMemoryManager::Gather(impl->gpu_dirty_memory_managers, callback);
 }
 
 PerfStatsResults System::GetAndResetPerfStats() {
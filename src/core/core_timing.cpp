@@ -2,9 +2,13 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <bit>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _WIN32
 #include "common/windows/timer_resolution.h"
@@ -22,6 +26,17 @@ namespace Core::Timing {
 
 constexpr s64 MAX_SLICE_LENGTH = 10000;
 
+// Slots on the lowest level of the timer wheel are 2^10 ns wide, and every level above covers the
+// whole level below with each of its slots. Events further away than the last level can reach
+// (about 73 minutes) wait in an overflow list.
+constexpr u32 WHEEL_GRANULARITY_BITS = 10;
+constexpr u32 WHEEL_LEVEL_BITS = 8;
+constexpr u32 WHEEL_LEVELS = 4;
+constexpr u32 WHEEL_SLOTS = 1U << WHEEL_LEVEL_BITS;
+constexpr u32 WHEEL_OVERFLOW_SLOT = WHEEL_LEVELS * WHEEL_SLOTS;
+constexpr u32 READY_SLOT = WHEEL_OVERFLOW_SLOT + 1;
+constexpr u32 NUM_INSERTION_BUFFERS = Hardware::NUM_CPU_CORES;
+
 std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callback) {
     return std::make_shared<EventType>(std::move(callback), std::move(name));
 }
@@ -31,7 +46,16 @@ struct CoreTiming::Event {
     u64 fifo_order;
     std::weak_ptr<EventType> type;
     s64 reschedule_time;
-    heap_t::handle_type handle{};
+    /// Identifies the type while it may be expired, only used as a key
+    const EventType* type_key;
+
+    u32 slot{};
+    bool is_cancelled{};
+    Event* slot_prev{};
+    Event* slot_next{};
+    Event* type_prev{};
+    Event* type_next{};
+    Event* buffer_next{};
 
     // Sort by time, unless the times are the same, in which case sort by
     // the order added to the queue
@@ -44,7 +68,327 @@ struct CoreTiming::Event {
     }
 };
 
-CoreTiming::CoreTiming() : clock{Common::CreateOptimalClock()} {}
+/**
+ * Hierarchical timer wheel holding the pending events.
+ *
+ * Events are linked into the slot of their due tick on the lowest level whose range still covers
+ * it, and cascade to lower levels as the wheel reaches their slot. Events of the current tick are
+ * moved to a small heap, so callbacks still run ordered by time and insertion order. Every event is
+ * also linked to the other events of its type, so they can be unscheduled without a search.
+ *
+ * Everything but Push and Empty requires the caller to hold the CoreTiming lock.
+ */
+class CoreTiming::EventQueue {
+public:
+    explicit EventQueue() = default;
+
+    ~EventQueue() {
+        Clear();
+    }
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    /// Adds an event from any thread, it's inserted in the wheel on the next locked operation.
+    void Push(std::unique_ptr<Event> event) {
+        static std::atomic<u32> next_buffer_index{};
+        thread_local const u32 buffer_index{next_buffer_index++ % NUM_INSERTION_BUFFERS};
+
+        num_events.fetch_add(1, std::memory_order_relaxed);
+        Event* const new_event{event.release()};
+        auto& head{buffers[buffer_index].head};
+        new_event->buffer_next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(new_event->buffer_next, new_event,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    /// Adds an event from the thread holding the lock.
+    void Add(std::unique_ptr<Event> event) {
+        num_events.fetch_add(1, std::memory_order_relaxed);
+        Event* const new_event{event.release()};
+        LinkType(new_event);
+        Insert(new_event);
+    }
+
+    /// Removes every pending event of the given type.
+    void Remove(const EventType* type) {
+        Drain();
+        const auto it{type_events.find(type)};
+        if (it == type_events.end()) {
+            return;
+        }
+        for (Event* event = it->second; event != nullptr;) {
+            Event* const next{event->type_next};
+            num_events.fetch_sub(1, std::memory_order_relaxed);
+            if (event->slot == READY_SLOT) {
+                // Removing from the middle of the heap is not worth it, it's skipped when popped
+                event->is_cancelled = true;
+            } else {
+                UnlinkSlot(event);
+                delete event;
+            }
+            event = next;
+        }
+        type_events.erase(it);
+    }
+
+    /// Pops the next event due at the given time, if there is any.
+    std::unique_ptr<Event> PopDue(s64 time) {
+        Drain();
+        AdvanceTo(TickOf(time));
+        while (!ready.empty()) {
+            Event* const event{ready.front()};
+            if (!event->is_cancelled && event->time > time) {
+                return nullptr;
+            }
+            std::pop_heap(ready.begin(), ready.end(), EventGreater{});
+            ready.pop_back();
+            std::unique_ptr<Event> owned_event{event};
+            if (!event->is_cancelled) {
+                UnlinkType(event);
+                num_events.fetch_sub(1, std::memory_order_relaxed);
+                return owned_event;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Returns the time of the next event. It may be earlier than the event when it's far away,
+    /// the wheel only knows the start of its slot.
+    std::optional<s64> NextTime() {
+        Drain();
+        while (!ready.empty() && ready.front()->is_cancelled) {
+            std::pop_heap(ready.begin(), ready.end(), EventGreater{});
+            delete ready.back();
+            ready.pop_back();
+        }
+        if (!ready.empty()) {
+            return ready.front()->time;
+        }
+        const std::optional<u64> tick{EarliestTick()};
+        if (!tick) {
+            return std::nullopt;
+        }
+        return static_cast<s64>(*tick << WHEEL_GRANULARITY_BITS);
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return num_events.load(std::memory_order_relaxed) == 0;
+    }
+
+    void Clear() {
+        Drain();
+        for (Event*& head : slots) {
+            while (head != nullptr) {
+                delete std::exchange(head, head->slot_next);
+            }
+        }
+        for (Event* const event : ready) {
+            delete event;
+        }
+        ready.clear();
+        occupied_slots = {};
+        overflow_min = std::numeric_limits<u64>::max();
+        wheel_size = 0;
+        type_events.clear();
+        num_events = 0;
+    }
+
+private:
+    struct EventGreater {
+        bool operator()(const Event* left, const Event* right) const {
+            return *left > *right;
+        }
+    };
+
+    struct alignas(128) InsertionBuffer {
+        std::atomic<Event*> head{};
+    };
+
+    static u64 TickOf(s64 time) {
+        return time > 0 ? static_cast<u64>(time) >> WHEEL_GRANULARITY_BITS : 0;
+    }
+
+    static u32 Digit(u64 tick, u32 level) {
+        return static_cast<u32>(tick >> (level * WHEEL_LEVEL_BITS)) & (WHEEL_SLOTS - 1);
+    }
+
+    void Drain() {
+        for (InsertionBuffer& buffer : buffers) {
+            if (buffer.head.load(std::memory_order_relaxed) == nullptr) {
+                continue;
+            }
+            Event* event{buffer.head.exchange(nullptr, std::memory_order_acquire)};
+            while (event != nullptr) {
+                Event* const next{event->buffer_next};
+                LinkType(event);
+                Insert(event);
+                event = next;
+            }
+        }
+    }
+
+    void LinkType(Event* event) {
+        Event*& head{type_events[event->type_key]};
+        event->type_prev = nullptr;
+        event->type_next = head;
+        if (head != nullptr) {
+            head->type_prev = event;
+        }
+        head = event;
+    }
+
+    void UnlinkType(Event* event) {
+        if (event->type_next != nullptr) {
+            event->type_next->type_prev = event->type_prev;
+        }
+        if (event->type_prev != nullptr) {
+            event->type_prev->type_next = event->type_next;
+        } else if (event->type_next != nullptr) {
+            type_events[event->type_key] = event->type_next;
+        } else {
+            type_events.erase(event->type_key);
+        }
+    }
+
+    void Insert(Event* event) {
+        const u64 tick{TickOf(event->time)};
+        if (tick <= current_tick) {
+            event->slot = READY_SLOT;
+            ready.push_back(event);
+            std::push_heap(ready.begin(), ready.end(), EventGreater{});
+            return;
+        }
+        u32 slot{WHEEL_OVERFLOW_SLOT};
+        for (u32 level = 0; level < WHEEL_LEVELS; ++level) {
+            const u32 shift{(level + 1) * WHEEL_LEVEL_BITS};
+            if ((tick >> shift) == (current_tick >> shift)) {
+                slot = level * WHEEL_SLOTS + Digit(tick, level);
+                break;
+            }
+        }
+        if (slot == WHEEL_OVERFLOW_SLOT) {
+            overflow_min = std::min(overflow_min, tick);
+        } else {
+            occupied_slots[slot / 64] |= u64{1} << (slot % 64);
+        }
+        event->slot = slot;
+        event->slot_prev = nullptr;
+        event->slot_next = slots[slot];
+        if (slots[slot] != nullptr) {
+            slots[slot]->slot_prev = event;
+        }
+        slots[slot] = event;
+        ++wheel_size;
+    }
+
+    void UnlinkSlot(Event* event) {
+        const u32 slot{event->slot};
+        if (event->slot_next != nullptr) {
+            event->slot_next->slot_prev = event->slot_prev;
+        }
+        if (event->slot_prev != nullptr) {
+            event->slot_prev->slot_next = event->slot_next;
+        } else {
+            slots[slot] = event->slot_next;
+        }
+        if (slots[slot] == nullptr) {
+            if (slot == WHEEL_OVERFLOW_SLOT) {
+                overflow_min = std::numeric_limits<u64>::max();
+            } else {
+                occupied_slots[slot / 64] &= ~(u64{1} << (slot % 64));
+            }
+        }
+        --wheel_size;
+    }
+
+    /// Returns the first tick of the earliest occupied slot.
+    std::optional<u64> EarliestTick() const {
+        if (wheel_size == 0) {
+            return std::nullopt;
+        }
+        // Slots up to the digit of the current tick are always empty, the first occupied slot of
+        // the lowest occupied level holds the earliest events
+        for (u32 level = 0; level < WHEEL_LEVELS; ++level) {
+            const u32 first_word{level * WHEEL_SLOTS / 64};
+            for (u32 word = first_word; word < first_word + WHEEL_SLOTS / 64; ++word) {
+                if (occupied_slots[word] == 0) {
+                    continue;
+                }
+                const u32 digit{(word - first_word) * 64 +
+                                static_cast<u32>(std::countr_zero(occupied_slots[word]))};
+                const u32 shift{level * WHEEL_LEVEL_BITS};
+                const u32 upper_shift{shift + WHEEL_LEVEL_BITS};
+                return ((current_tick >> upper_shift) << upper_shift) | (u64{digit} << shift);
+            }
+        }
+        return overflow_min;
+    }
+
+    void AdvanceTo(u64 target_tick) {
+        if (target_tick < current_tick) {
+            // Time only goes back after the clock is reset, follow it once nothing depends on it
+            if (wheel_size == 0) {
+                current_tick = target_tick;
+            }
+            return;
+        }
+        // Jump from occupied slot to occupied slot instead of walking every tick
+        while (current_tick < target_tick) {
+            const std::optional<u64> next_tick{EarliestTick()};
+            current_tick = next_tick ? std::min(*next_tick, target_tick) : target_tick;
+            Cascade();
+        }
+    }
+
+    /// Moves the events of the slots the current tick has reached to lower levels, or to the ready
+    /// heap when they're due in the current tick.
+    void Cascade() {
+        constexpr u32 top_shift{WHEEL_LEVELS * WHEEL_LEVEL_BITS};
+        if (slots[WHEEL_OVERFLOW_SLOT] != nullptr &&
+            (overflow_min >> top_shift) <= (current_tick >> top_shift)) {
+            Reinsert(WHEEL_OVERFLOW_SLOT);
+        }
+        for (u32 level = WHEEL_LEVELS; level-- > 0;) {
+            Reinsert(level * WHEEL_SLOTS + Digit(current_tick, level));
+        }
+    }
+
+    void Reinsert(u32 slot) {
+        Event* event{std::exchange(slots[slot], nullptr)};
+        if (event == nullptr) {
+            return;
+        }
+        if (slot == WHEEL_OVERFLOW_SLOT) {
+            overflow_min = std::numeric_limits<u64>::max();
+        } else {
+            occupied_slots[slot / 64] &= ~(u64{1} << (slot % 64));
+        }
+        while (event != nullptr) {
+            Event* const next{event->slot_next};
+            --wheel_size;
+            Insert(event);
+            event = next;
+        }
+    }
+
+    std::array<InsertionBuffer, NUM_INSERTION_BUFFERS> buffers{};
+    std::atomic<size_t> num_events{};
+
+    u64 current_tick{};
+    size_t wheel_size{};
+    u64 overflow_min{std::numeric_limits<u64>::max()};
+    std::array<Event*, WHEEL_OVERFLOW_SLOT + 1> slots{};
+    std::array<u64, WHEEL_LEVELS * WHEEL_SLOTS / 64> occupied_slots{};
+    std::vector<Event*> ready;
+
+    std::unordered_map<const EventType*, Event*> type_events;
+};
+
+CoreTiming::CoreTiming()
+    : clock{Common::CreateOptimalClock()}, event_queue{std::make_unique<EventQueue>()} {}
 
 CoreTiming::~CoreTiming() {
     Reset();
@@ -73,7 +417,7 @@ void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
 
 void CoreTiming::ClearPendingEvents() {
     std::scoped_lock lock{advance_lock, basic_lock};
-    event_queue.clear();
+    event_queue->Clear();
     event.Set();
 }
 
@@ -111,19 +455,19 @@ bool CoreTiming::IsRunning() const {
 }
 
 bool CoreTiming::HasPendingEvents() const {
-    std::scoped_lock lock{basic_lock};
-    return !(wait_set && event_queue.empty());
+    return !(wait_set && event_queue->Empty());
 }
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                                const std::shared_ptr<EventType>& event_type, bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
-
-        auto h{event_queue.emplace(Event{next_time.count(), event_fifo_id++, event_type, 0})};
-        (*h).handle = h;
-    }
+    const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
+    event_queue->Push(std::make_unique<Event>(Event{
+        .time = next_time.count(),
+        .fifo_order = event_fifo_id.fetch_add(1, std::memory_order_relaxed),
+        .type = event_type,
+        .reschedule_time = 0,
+        .type_key = event_type.get(),
+    }));
 
     event.Set();
 }
@@ -132,14 +476,14 @@ void CoreTiming::ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
                                       std::chrono::nanoseconds resched_time,
                                       const std::shared_ptr<EventType>& event_type,
                                       bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
-
-        auto h{event_queue.emplace(
-            Event{next_time.count(), event_fifo_id++, event_type, resched_time.count()})};
-        (*h).handle = h;
-    }
+    const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
+    event_queue->Push(std::make_unique<Event>(Event{
+        .time = next_time.count(),
+        .fifo_order = event_fifo_id.fetch_add(1, std::memory_order_relaxed),
+        .type = event_type,
+        .reschedule_time = resched_time.count(),
+        .type_key = event_type.get(),
+    }));
 
     event.Set();
 }
@@ -148,19 +492,7 @@ void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                                  UnscheduleEventType type) {
     {
         std::scoped_lock lk{basic_lock};
-
-        std::vector<heap_t::handle_type> to_remove;
-        for (auto itr = event_queue.begin(); itr != event_queue.end(); itr++) {
-            const Event& e = *itr;
-            if (e.type.lock().get() == event_type.get()) {
-                to_remove.push_back(itr->handle);
-            }
-        }
-
-        for (auto& h : to_remove) {
-            event_queue.erase(h);
-        }
-
+        event_queue->Remove(event_type.get());
         event_type->sequence_number++;
     }
 
@@ -201,16 +533,12 @@ std::optional<s64> CoreTiming::Advance() {
     std::scoped_lock lock{advance_lock, basic_lock};
     global_timer = GetGlobalTimeNs().count();
 
-    while (!event_queue.empty() && event_queue.top().time <= global_timer) {
-        const Event& evt = event_queue.top();
-
-        if (const auto event_type{evt.type.lock()}) {
-            const auto evt_time = evt.time;
+    while (auto evt = event_queue->PopDue(global_timer)) {
+        if (const auto event_type{evt->type.lock()}) {
+            const auto evt_time = evt->time;
             const auto evt_sequence_num = event_type->sequence_number;
 
-            if (evt.reschedule_time == 0) {
-                event_queue.pop();
-
+            if (evt->reschedule_time == 0) {
                 basic_lock.unlock();
 
                 event_type->callback(
@@ -226,34 +554,32 @@ std::optional<s64> CoreTiming::Advance() {
                 basic_lock.lock();
 
                 if (evt_sequence_num != event_type->sequence_number) {
-                    // Heap handle is invalidated after external modification.
+                    // The event was unscheduled while its callback ran.
                     continue;
                 }
 
                 const auto next_schedule_time{new_schedule_time.has_value()
                                                   ? new_schedule_time.value().count()
-                                                  : evt.reschedule_time};
+                                                  : evt->reschedule_time};
 
                 // If this event was scheduled into a pause, its time now is going to be way
                 // behind. Re-set this event to continue from the end of the pause.
-                auto next_time{evt.time + next_schedule_time};
-                if (evt.time < pause_end_time) {
+                auto next_time{evt->time + next_schedule_time};
+                if (evt->time < pause_end_time) {
                     next_time = pause_end_time + next_schedule_time;
                 }
 
-                event_queue.update(evt.handle, Event{next_time, event_fifo_id++, evt.type,
-                                                     next_schedule_time, evt.handle});
+                evt->time = next_time;
+                evt->fifo_order = event_fifo_id.fetch_add(1, std::memory_order_relaxed);
+                evt->reschedule_time = next_schedule_time;
+                event_queue->Add(std::move(evt));
             }
         }
 
         global_timer = GetGlobalTimeNs().count();
     }
 
-    if (!event_queue.empty()) {
-        return event_queue.top().time;
-    } else {
-        return std::nullopt;
-    }
+    return event_queue->NextTime();
 }
 
 void CoreTiming::ThreadLoop() {
@@ -12,8 +12,6 @@
 #include <string>
 #include <thread>
 
-#include <boost/heap/fibonacci_heap.hpp>
-
 #include "common/common_types.h"
 #include "common/thread.h"
 #include "common/wall_clock.h"
@@ -47,6 +45,10 @@ enum class UnscheduleEventType {
  * This is a system to schedule events into the emulated machine's future. Time is measured
  * in main CPU clock cycles.
  *
+ * Pending events are kept in a hierarchical timer wheel. Scheduling doesn't take a lock, new
+ * events are pushed to per-thread insertion buffers that are drained on the next Advance or
+ * UnscheduleEvent.
+ *
  * To schedule an event, you first have to register its type. This is where you pass in the
  * callback. You then schedule events using the type ID you get back.
  *
@@ -95,7 +97,7 @@ public:
     /// Checks if there are any pending time events.
     bool HasPendingEvents() const;
 
-    /// Schedules an event in core timing
+    /// Schedules an event in core timing, threadsafe and lock-free
     void ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                        const std::shared_ptr<EventType>& event_type, bool absolute_time = false);
 
@@ -140,6 +142,7 @@ public:
 
 private:
     struct Event;
+    class EventQueue;
 
     static void ThreadEntry(CoreTiming& instance);
     void ThreadLoop();
@@ -154,11 +157,8 @@ private:
     s64 timer_resolution_ns;
 #endif
 
-    using heap_t =
-        boost::heap::fibonacci_heap<CoreTiming::Event, boost::heap::compare<std::greater<>>>;
-
-    heap_t event_queue;
-    u64 event_fifo_id = 0;
+    std::unique_ptr<EventQueue> event_queue;
+    std::atomic<u64> event_fifo_id{};
 
     Common::Event event{};
     Common::Event pause_event{};
@@ -20,6 +20,7 @@
 #include "core/core.h"
 #include "core/debugger/gdbstub.h"
 #include "core/debugger/gdbstub_arch.h"
+#include "core/hle/kernel/global_scheduler_context.h"
 #include "core/hle/kernel/k_page_table.h"
 #include "core/hle/kernel/k_process.h"
 #include "core/hle/kernel/k_thread.h"
@@ -615,7 +616,13 @@ void GDBStub::HandleRcmd(const std::vector<u8>& command) {
     const char* commands = "Commands:\n"
                            "  get fastmem\n"
                            "  get info\n"
-                           "  get mappings\n";
+                           "  get mappings\n"
+                           "  get schedlock\n"
+                           "  set schedlock on|off\n"
+                           "  reset schedlock\n";
+
+    auto& scheduler_lock_profiler =
+        system.Kernel().GlobalSchedulerContext().SchedulerLock().GetProfiler();
 
     if (command_str == "get fastmem") {
         if (Settings::IsFastmemEnabled()) {
@@ -698,6 +705,21 @@ void GDBStub::HandleRcmd(const std::vector<u8>& command) {
 
             cur_addr = next_address;
         }
+    } else if (command_str == "get schedlock") {
+        if (scheduler_lock_profiler.IsEnabled()) {
+            reply = scheduler_lock_profiler.Dump();
+        } else {
+            reply = "Scheduler lock profiling is not enabled.\n";
+        }
+    } else if (command_str == "set schedlock on") {
+        scheduler_lock_profiler.SetEnabled(true);
+        reply = "Scheduler lock profiling enabled.\n";
+    } else if (command_str == "set schedlock off") {
+        scheduler_lock_profiler.SetEnabled(false);
+        reply = "Scheduler lock profiling disabled.\n";
+    } else if (command_str == "reset schedlock") {
+        scheduler_lock_profiler.Reset();
+        reply = "Scheduler lock profile cleared.\n";
     } else if (command_str == "help") {
         reply = commands;
     } else {
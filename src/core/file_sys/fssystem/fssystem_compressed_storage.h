@@ -3,6 +3,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "common/literals.h"
 
 #include "core/file_sys/errors.h"
@@ -690,6 +696,13 @@ private:
         };
         static_assert(std::is_trivial_v<AccessRange>);
 
+        struct CacheEntry {
+            s64 virtual_offset;
+            std::vector<u8> data;
+        };
+
+        using CacheList = std::list<CacheEntry>;
+
     public:
         CacheManager() = default;
 
@@ -699,9 +712,30 @@ private:
             // Set our fields.
             m_storage_size = storage_size;
 
+            // Set up our block cache. cache_size_0 is the largest decompressed block we will
+            // keep, and cache_size_1 is the total size of all blocks held at once.
+            m_cache_block_size_max = cache_size_0;
+            m_cache_size_max = std::max(cache_size_0, cache_size_1);
+            m_cache_entries_max = max_cache_entries;
+
             R_SUCCEED();
         }
 
+        void Finalize() {
+            std::scoped_lock lk(m_cache_mutex);
+            m_cache_list.clear();
+            m_cache_map.clear();
+            m_cache_size = 0;
+        }
+
+        u64 GetCacheHitCount() const {
+            return m_cache_hit_count.load(std::memory_order_relaxed);
+        }
+
+        u64 GetCacheMissCount() const {
+            return m_cache_miss_count.load(std::memory_order_relaxed);
+        }
+
         Result Read(CompressedStorageCore& core, s64 offset, void* buffer, size_t size) {
             // If we have nothing to read, succeed.
             R_SUCCEED_IF(size == 0);
@@ -715,72 +749,56 @@ private:
             // Determine how much we can read.
             const size_t read_size = std::min<size_t>(size, m_storage_size - offset);
 
+            // Begin performing the accesses.
+            s64 cur_offset = offset;
+            size_t cur_size = read_size;
+            char* cur_dst = static_cast<char*>(buffer);
+
             // Create head/tail ranges.
             AccessRange head_range = {};
             AccessRange tail_range = {};
-            bool is_tail_set = false;
 
-            // Operate to determine the head range.
-            R_TRY(core.OperatePerEntry(
-                offset, 1,
-                [&](bool* out_continuous, const Entry& entry, s64 virtual_data_size,
-                    s64 data_offset, s64 data_read_size) -> Result {
-                    // Set the head range.
-                    head_range = {
-                        .virtual_offset = entry.virt_offset,
-                        .virtual_size = virtual_data_size,
-                        .physical_size = static_cast<u32>(entry.phys_size),
-                        .is_block_alignment_required =
-                            CompressionTypeUtility::IsBlockAlignmentRequired(
-                                entry.compression_type),
-                    };
+            // Serve as much of the head and tail of the access as we can from the block cache.
+            while (true) {
+                // Determine the head and tail ranges for the remaining access.
+                R_TRY(this->GetAccessRanges(std::addressof(head_range), std::addressof(tail_range),
+                                            core, cur_offset, cur_size));
+
+                // Try to serve the head from a cached block.
+                if (head_range.is_block_alignment_required) {
+                    const size_t skip_size = cur_offset - head_range.virtual_offset;
+                    const size_t copy_size = std::min<size_t>(
+                        cur_size, head_range.GetEndVirtualOffset() - cur_offset);
+                    if (this->ReadFromCache(cur_dst, head_range.virtual_offset, skip_size,
+                                            copy_size)) {
+                        // Advance.
+                        cur_dst += copy_size;
+                        cur_offset += copy_size;
+                        cur_size -= copy_size;
 
-                    // If required, set the tail range.
-                    if (static_cast<s64>(offset + read_size) <=
-                        entry.virt_offset + virtual_data_size) {
-                        tail_range = {
-                            .virtual_offset = entry.virt_offset,
-                            .virtual_size = virtual_data_size,
-                            .physical_size = static_cast<u32>(entry.phys_size),
-                            .is_block_alignment_required =
-                                CompressionTypeUtility::IsBlockAlignmentRequired(
-                                    entry.compression_type),
-                        };
-                        is_tail_set = true;
+                        // If we've read everything, we're done.
+                        R_SUCCEED_IF(cur_size == 0);
+                        continue;
                     }
+                }
 
-                    // We only want to determine the head range, so we're not continuous.
-                    *out_continuous = false;
-                    R_SUCCEED();
-                }));
-
-            // If necessary, determine the tail range.
-            if (!is_tail_set) {
-                R_TRY(core.OperatePerEntry(
-                    offset + read_size - 1, 1,
-                    [&](bool* out_continuous, const Entry& entry, s64 virtual_data_size,
-                        s64 data_offset, s64 data_read_size) -> Result {
-                        // Set the tail range.
-                        tail_range = {
-                            .virtual_offset = entry.virt_offset,
-                            .virtual_size = virtual_data_size,
-                            .physical_size = static_cast<u32>(entry.phys_size),
-                            .is_block_alignment_required =
-                                CompressionTypeUtility::IsBlockAlignmentRequired(
-                                    entry.compression_type),
-                        };
+                // Try to serve the tail from a cached block.
+                if (tail_range.is_block_alignment_required &&
+                    cur_offset < tail_range.virtual_offset) {
+                    const size_t tail_skip_size = tail_range.virtual_offset - cur_offset;
+                    const size_t copy_size = cur_size - tail_skip_size;
+                    if (this->ReadFromCache(cur_dst + tail_skip_size, tail_range.virtual_offset, 0,
+                                            copy_size)) {
+                        // Shrink the access.
+                        cur_size -= copy_size;
+                        continue;
+                    }
+                }
 
-                        // We only want to determine the tail range, so we're not continuous.
-                        *out_continuous = false;
-                        R_SUCCEED();
-                    }));
+                // Neither end is cached, so we need to go to the core.
+                break;
             }
 
-            // Begin performing the accesses.
-            s64 cur_offset = offset;
-            size_t cur_size = read_size;
-            char* cur_dst = static_cast<char*>(buffer);
-
             // Determine our alignment.
             const bool head_unaligned = head_range.is_block_alignment_required &&
                                         (cur_offset != head_range.virtual_offset ||
@@ -879,6 +897,11 @@ private:
 
                         std::memcpy(cur_dst, pooled_buffer.GetBuffer() + skip_size, copy_size);
 
+                        // Keep the decompressed block around for subsequent accesses.
+                        m_cache_miss_count.fetch_add(1, std::memory_order_relaxed);
+                        this->StoreToCache(unaligned_range->virtual_offset,
+                                           pooled_buffer.GetBuffer(), size_buffer_required);
+
                         // Advance.
                         cur_dst += copy_size;
                         cur_offset += copy_size;
@@ -891,8 +914,131 @@ private:
             R_SUCCEED();
         }
 
+    private:
+        Result GetAccessRanges(AccessRange* out_head, AccessRange* out_tail,
+                               CompressedStorageCore& core, s64 offset, size_t size) {
+            bool is_tail_set = false;
+
+            // Operate to determine the head range.
+            R_TRY(core.OperatePerEntry(
+                offset, 1,
+                [&](bool* out_continuous, const Entry& entry, s64 virtual_data_size,
+                    s64 data_offset, s64 data_read_size) -> Result {
+                    // Set the head range.
+                    *out_head = {
+                        .virtual_offset = entry.virt_offset,
+                        .virtual_size = virtual_data_size,
+                        .physical_size = static_cast<u32>(entry.phys_size),
+                        .is_block_alignment_required =
+                            CompressionTypeUtility::IsBlockAlignmentRequired(
+                                entry.compression_type),
+                    };
+
+                    // If required, set the tail range.
+                    if (static_cast<s64>(offset + size) <= entry.virt_offset + virtual_data_size) {
+                        *out_tail = *out_head;
+                        is_tail_set = true;
+                    }
+
+                    // We only want to determine the head range, so we're not continuous.
+                    *out_continuous = false;
+                    R_SUCCEED();
+                }));
+
+            // If necessary, determine the tail range.
+            if (!is_tail_set) {
+                R_TRY(core.OperatePerEntry(
+                    offset + size - 1, 1,
+                    [&](bool* out_continuous, const Entry& entry, s64 virtual_data_size,
+                        s64 data_offset, s64 data_read_size) -> Result {
+                        // Set the tail range.
+                        *out_tail = {
+                            .virtual_offset = entry.virt_offset,
+                            .virtual_size = virtual_data_size,
+                            .physical_size = static_cast<u32>(entry.phys_size),
+                            .is_block_alignment_required =
+                                CompressionTypeUtility::IsBlockAlignmentRequired(
+                                    entry.compression_type),
+                        };
+
+                        // We only want to determine the tail range, so we're not continuous.
+                        *out_continuous = false;
+                        R_SUCCEED();
+                    }));
+            }
+
+            R_SUCCEED();
+        }
+
+        bool ReadFromCache(void* dst, s64 virtual_offset, size_t skip_size, size_t size) {
+            std::scoped_lock lk(m_cache_mutex);
+
+            // Find the block.
+            const auto it = m_cache_map.find(virtual_offset);
+            if (it == m_cache_map.end()) {
+                return false;
+            }
+            m_cache_hit_count.fetch_add(1, std::memory_order_relaxed);
+
+            // Move the block to the front of the list, as it is now the most recently used.
+            m_cache_list.splice(m_cache_list.begin(), m_cache_list, it->second);
+
+            // Copy out the data.
+            const auto& data = it->second->data;
+            ASSERT(skip_size + size <= data.size());
+            std::memcpy(dst, data.data() + skip_size, size);
+            return true;
+        }
+
+        void StoreToCache(s64 virtual_offset, const void* src, size_t size) {
+            // Check that the block is eligible for caching.
+            if (m_cache_entries_max == 0 || size > m_cache_block_size_max) {
+                return;
+            }
+
+            std::scoped_lock lk(m_cache_mutex);
+
+            // Another reader may have cached this block while we were decompressing it.
+            if (m_cache_map.contains(virtual_offset)) {
+                return;
+            }
+
+            // Evict the least recently used blocks until the new one fits, reusing the last
+            // evicted buffer to store it.
+            std::vector<u8> data;
+            while (!m_cache_list.empty() && (m_cache_list.size() >= m_cache_entries_max ||
+                                             m_cache_size + size > m_cache_size_max)) {
+                auto& victim = m_cache_list.back();
+                m_cache_size -= victim.data.size();
+                m_cache_map.erase(victim.virtual_offset);
+                data = std::move(victim.data);
+                m_cache_list.pop_back();
+            }
+
+            // Insert the block as the most recently used.
+            data.resize(size);
+            std::memcpy(data.data(), src, size);
+            m_cache_list.push_front({
+                .virtual_offset = virtual_offset,
+                .data = std::move(data),
+            });
+            m_cache_map.emplace(virtual_offset, m_cache_list.begin());
+            m_cache_size += size;
+        }
+
     private:
         s64 m_storage_size = 0;
+        size_t m_cache_block_size_max = 0;
+        size_t m_cache_size_max = 0;
+        size_t m_cache_entries_max = 0;
+
+        std::mutex m_cache_mutex;
+        CacheList m_cache_list;
+        std::unordered_map<s64, CacheList::iterator> m_cache_map;
+        size_t m_cache_size = 0;
+
+        std::atomic<u64> m_cache_hit_count = 0;
+        std::atomic<u64> m_cache_miss_count = 0;
     };
 
 public:
@@ -920,6 +1066,7 @@ public:
     }
 
     void Finalize() {
+        m_cache_manager.Finalize();
         m_core.Finalize();
     }
 
@@ -940,6 +1087,14 @@ public:
         return m_core.GetEntryTable();
     }
 
+    u64 GetCacheHitCount() const {
+        return m_cache_manager.GetCacheHitCount();
+    }
+
+    u64 GetCacheMissCount() const {
+        return m_cache_manager.GetCacheMissCount();
+    }
+
 public:
     virtual size_t GetSize() const override {
         s64 ret{};
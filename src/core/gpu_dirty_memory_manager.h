@@ -3,23 +3,32 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <bit>
 #include <functional>
 #include <mutex>
+#include <span>
 #include <utility>
 #include <vector>
 
+#include "common/ring_buffer.h"
 #include "core/device_memory_manager.h"
 
 namespace Core {
 
+/**
+ * Collects the guest memory written by the CPU, so the GPU can invalidate its caches of it.
+ *
+ * There is one manager per guest core. Writes are combined into a mask of the current page, which
+ * is staged in a ring buffer when the core moves on to another page. Gather drains the staged pages
+ * of every manager and merges them, so each dirty range is reported once, however many cores wrote
+ * to it. The last manager is shared by every thread that isn't a guest core, so any number of
+ * threads may collect into a manager at once.
+ */
 class GPUDirtyMemoryManager {
 public:
-    GPUDirtyMemoryManager() : current{default_transform} {
-        back_buffer.reserve(256);
-        front_buffer.reserve(256);
-    }
+    GPUDirtyMemoryManager() : current{default_transform} {}
 
     ~GPUDirtyMemoryManager() = default;
 
@@ -31,10 +40,11 @@ public:
             original = tmp;
             if (tmp.address != t.address) {
                 if (IsValid(tmp.address)) {
-                    std::scoped_lock lk(guard);
-                    back_buffer.emplace_back(tmp);
-                    current.exchange(t, std::memory_order_relaxed);
-                    return;
+                    // Stage the previous page before replacing it, if Gather takes it in between
+                    // it's only reported twice.
+                    Stage(tmp);
+                    tmp = t;
+                    continue;
                 }
                 tmp.address = t.address;
                 tmp.mask = 0;
@@ -48,30 +58,61 @@ public:
     }
 
     void Gather(std::function<void(PAddr, size_t)>& callback) {
-        {
-            std::scoped_lock lk(guard);
-            TransformAddress t = current.exchange(default_transform, std::memory_order_relaxed);
-            front_buffer.swap(back_buffer);
-            if (IsValid(t.address)) {
-                front_buffer.emplace_back(t);
-            }
+        Gather(std::span(this, 1), callback);
+    }
+
+    /// Reports the ranges written through any of the managers, adjacent ranges are merged.
+    static void Gather(std::span<GPUDirtyMemoryManager> managers,
+                       std::function<void(PAddr, size_t)>& callback) {
+        thread_local std::vector<TransformAddress> transforms;
+        for (GPUDirtyMemoryManager& manager : managers) {
+            manager.Drain(transforms);
+        }
+        if (transforms.empty()) {
+            return;
         }
-        for (auto& transform : front_buffer) {
+
+        // Combine the masks of every page, pages written by several cores or several times appear
+        // more than once.
+        std::ranges::sort(transforms, {}, &TransformAddress::address);
+
+        PAddr run_address = 0;
+        size_t run_size = 0;
+        const auto emit = [&](PAddr address, size_t size) {
+            if (run_size != 0 && run_address + run_size == address) {
+                run_size += size;
+                return;
+            }
+            if (run_size != 0) {
+                callback(run_address, run_size);
+            }
+            run_address = address;
+            run_size = size;
+        };
+        for (auto it = transforms.begin(); it != transforms.end();) {
+            const u32 address = it->address;
+            u32 mask = 0;
+            for (; it != transforms.end() && it->address == address; ++it) {
+                mask |= it->mask;
+            }
+
+            const PAddr page_address = static_cast<PAddr>(address) << page_bits;
             size_t offset = 0;
-            u64 mask = transform.mask;
             while (mask != 0) {
                 const size_t empty_bits = std::countr_zero(mask);
                 offset += empty_bits << align_bits;
-                mask = mask >> empty_bits;
+                mask >>= empty_bits;
 
                 const size_t continuous_bits = std::countr_one(mask);
-                callback((static_cast<PAddr>(transform.address) << page_bits) + offset,
-                         continuous_bits << align_bits);
-                mask = continuous_bits < align_size ? (mask >> continuous_bits) : 0;
+                emit(page_address + offset, continuous_bits << align_bits);
+                mask = continuous_bits < 32 ? (mask >> continuous_bits) : 0;
                 offset += continuous_bits << align_bits;
             }
         }
-        front_buffer.clear();
+        if (run_size != 0) {
+            callback(run_address, run_size);
+        }
+        transforms.clear();
     }
 
 private:
@@ -89,6 +130,8 @@ private:
     constexpr static size_t align_mask = align_size - 1;
     constexpr static TransformAddress default_transform = {.address = ~0U, .mask = 0U};
 
+    constexpr static size_t staging_capacity = 1024;
+
     bool IsValid(PAddr address) {
         return address < (1ULL << 39);
     }
@@ -113,10 +156,44 @@ private:
         return result;
     }
 
+    void Stage(const TransformAddress& transform) {
+        {
+            // The staging ring has a single producer, only the shared manager ever waits here.
+            std::scoped_lock lk{stage_guard};
+            if (staging.Push(&transform, 1) == 1) [[likely]] {
+                return;
+            }
+        }
+        // The GPU hasn't gathered in a while, keep the rest aside.
+        std::scoped_lock lk{overflow_guard};
+        overflow.push_back(transform);
+    }
+
+    void Drain(std::vector<TransformAddress>& out) {
+        // The staging ring has a single consumer.
+        std::scoped_lock lk{drain_guard};
+
+        const TransformAddress t = current.exchange(default_transform, std::memory_order_acq_rel);
+
+        const size_t offset = out.size();
+        out.resize(offset + staging.Size());
+        out.resize(offset + staging.Pop(out.data() + offset, out.size() - offset));
+        {
+            std::scoped_lock lk_overflow{overflow_guard};
+            out.insert(out.end(), overflow.begin(), overflow.end());
+            overflow.clear();
+        }
+        if (IsValid(t.address)) {
+            out.push_back(t);
+        }
+    }
+
     std::atomic<TransformAddress> current{};
-    std::mutex guard;
-    std::vector<TransformAddress> back_buffer;
-    std::vector<TransformAddress> front_buffer;
+    Common::RingBuffer<TransformAddress, staging_capacity> staging;
+    std::mutex stage_guard;
+    std::mutex drain_guard;
+    std::mutex overflow_guard;
+    std::vector<TransformAddress> overflow;
 };
 
 } // namespace Core
@@ -47,17 +47,7 @@ public:
         static_assert(FLAGS & GuestMemoryFlags::Read || FLAGS & GuestMemoryFlags::Write);
         if constexpr (!(FLAGS & GuestMemoryFlags::Read)) {
             if (!this->TrySetSpan()) {
-                if (backup) {
-                    backup->resize_destructive(this->size());
-                    m_data_span = *backup;
-                    m_span_valid = true;
-                    m_is_data_copy = true;
-                } else {
-                    m_data_copy.resize(this->size());
-                    m_data_span = std::span(m_data_copy);
-                    m_span_valid = true;
-                    m_is_data_copy = true;
-                }
+                this->SetDataCopy(backup);
             }
         } else if constexpr (FLAGS & GuestMemoryFlags::Read) {
             Read(addr, size, backup);
@@ -157,6 +147,21 @@ public:
         }
     }
 
+    /// Writes to a copy of the memory instead of in place, for write-only memory that must not
+    /// be observed before it's written back.
+    void SetDataCopy(Common::ScratchBuffer<T>* backup = nullptr) noexcept {
+        static_assert(!(FLAGS & GuestMemoryFlags::Read), "The copy would not hold the read data");
+        if (backup) {
+            backup->resize_destructive(this->size());
+            m_data_span = *backup;
+        } else {
+            m_data_copy.resize(this->size());
+            m_data_span = std::span(m_data_copy);
+        }
+        m_span_valid = true;
+        m_is_data_copy = true;
+    }
+
     bool TrySetSpan() noexcept {
         if (u8* ptr = m_memory->GetSpan(m_addr, this->size_bytes()); ptr) {
             m_data_span = {reinterpret_cast<T*>(ptr), this->size()};
@@ -4,6 +4,8 @@
 #include <mutex>
 
 #include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/hle/kernel/global_scheduler_context.h"
 #include "core/hle/kernel/k_scheduler.h"
@@ -13,9 +15,16 @@
 namespace Kernel {
 
 GlobalSchedulerContext::GlobalSchedulerContext(KernelCore& kernel)
-    : m_kernel{kernel}, m_scheduler_lock{kernel} {}
+    : m_kernel{kernel}, m_scheduler_lock{kernel} {
+    m_scheduler_lock.GetProfiler().SetEnabled(Settings::values.profile_scheduler_lock.GetValue());
+}
 
-GlobalSchedulerContext::~GlobalSchedulerContext() = default;
+GlobalSchedulerContext::~GlobalSchedulerContext() {
+    // Log what the scheduler lock profiler recorded over the session.
+    if (const auto& profiler = m_scheduler_lock.GetProfiler(); profiler.IsEnabled()) {
+        LOG_INFO(Kernel, "{}", profiler.Dump());
+    }
+}
 
 void GlobalSchedulerContext::AddThread(KThread* thread) {
     std::scoped_lock lock{m_global_list_guard};
@@ -377,7 +377,7 @@ public:
         m_scheduled_queue.MoveToFront(member->GetPriority(), member->GetActiveCore(), member);
     }
 
-    constexpr KThread* MoveToScheduledBack(Member* member) {
+    constexpr Member* MoveToScheduledBack(Member* member) {
         // This is for host (dummy) threads that we do not want to enter the priority queue.
         if (member->IsDummyThread()) {
             return {};
@@ -420,24 +420,24 @@ public:
         const s32 new_core = member->GetActiveCore();
 
         // Remove the member from all queues it was in before.
-        for (s32 core = 0; core < static_cast<s32>(NumCores); core++) {
-            if (prev_affinity.GetAffinity(core)) {
-                if (core == prev_core) {
-                    m_scheduled_queue.Remove(priority, core, member);
-                } else {
-                    m_suggested_queue.Remove(priority, core, member);
-                }
+        u64 prev_affinity_mask = prev_affinity.GetAffinityMask();
+        while (prev_affinity_mask) {
+            const s32 core = GetNextCore(prev_affinity_mask);
+            if (core == prev_core) {
+                m_scheduled_queue.Remove(priority, core, member);
+            } else {
+                m_suggested_queue.Remove(priority, core, member);
             }
         }
 
         // And add the member to all queues it should be in now.
-        for (s32 core = 0; core < static_cast<s32>(NumCores); core++) {
-            if (new_affinity.GetAffinity(core)) {
-                if (core == new_core) {
-                    m_scheduled_queue.PushBack(priority, core, member);
-                } else {
-                    m_suggested_queue.PushBack(priority, core, member);
-                }
+        u64 new_affinity_mask = new_affinity.GetAffinityMask();
+        while (new_affinity_mask) {
+            const s32 core = GetNextCore(new_affinity_mask);
+            if (core == new_core) {
+                m_scheduled_queue.PushBack(priority, core, member);
+            } else {
+                m_suggested_queue.PushBack(priority, core, member);
             }
         }
     }
@@ -10,6 +10,7 @@
 #include "core/hle/kernel/k_thread.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/physical_core.h"
+#include "core/hle/kernel/scheduler_lock_profiler.h"
 
 namespace Kernel {
 
@@ -33,6 +34,8 @@ public:
         } else {
             // Otherwise, we want to disable scheduling and acquire the spinlock.
             SchedulerType::DisableScheduling(m_kernel);
+            const bool is_profiling = m_profiler.IsEnabled();
+            const u64 wait_start = is_profiling ? m_profiler.BeginWait() : 0;
             m_spin_lock.Lock();
 
             ASSERT(m_lock_count == 0);
@@ -40,6 +43,12 @@ public:
 
             // Take ownership of the lock.
             m_owner_thread = GetCurrentThreadPointer(m_kernel);
+
+            // Note when we started holding it, if we're profiling.
+            m_is_profiling = is_profiling;
+            if (is_profiling) {
+                m_hold_start = m_profiler.EndWait(wait_start, m_owner_thread);
+            }
         }
 
         // Increment the lock count.
@@ -59,6 +68,11 @@ public:
             const u64 cores_needing_scheduling =
                 SchedulerType::UpdateHighestPriorityThreads(m_kernel);
 
+            // Record how long we held the lock, if we're profiling.
+            if (m_is_profiling) {
+                m_profiler.EndHold(m_hold_start, m_owner_thread);
+            }
+
             // Note that we no longer hold the lock, and unlock the spinlock.
             m_owner_thread = nullptr;
             m_spin_lock.Unlock();
@@ -68,6 +82,14 @@ public:
         }
     }
 
+    SchedulerLockProfiler& GetProfiler() {
+        return m_profiler;
+    }
+
+    const SchedulerLockProfiler& GetProfiler() const {
+        return m_profiler;
+    }
+
 private:
     friend class GlobalSchedulerContext;
 
@@ -75,6 +97,9 @@ private:
     KAlignedSpinLock m_spin_lock{};
     s32 m_lock_count{};
     std::atomic<KThread*> m_owner_thread{};
+    SchedulerLockProfiler m_profiler{};
+    u64 m_hold_start{};
+    bool m_is_profiling{};
 };
 
 } // namespace Kernel
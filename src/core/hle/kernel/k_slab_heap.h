@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 
 #include "common/assert.h"
@@ -17,6 +18,11 @@ class KernelCore;
 
 namespace impl {
 
+/**
+ * Free list of a slab heap, with a small cache of free objects (a magazine) per host thread group
+ * in front of it. Threads allocate from and free to their magazine, so they rarely contend on the
+ * shared list. Magazines exchange objects with the shared list in batches.
+ */
 class KSlabHeapImpl {
     SUYU_NON_COPYABLE(KSlabHeapImpl);
     SUYU_NON_MOVEABLE(KSlabHeapImpl);
@@ -26,6 +32,9 @@ public:
         Node* next{};
     };
 
+    static constexpr size_t NumMagazines = 4;
+    static constexpr size_t MagazineSize = 16;
+
 public:
     constexpr KSlabHeapImpl() = default;
 
@@ -40,32 +49,103 @@ public:
     void* Allocate() {
         // KScopedInterruptDisable di;
 
+        Magazine& magazine = m_magazines[GetMagazineIndex()];
+        magazine.lock.lock();
+        Node* ret = magazine.head;
+        if (ret != nullptr) [[likely]] {
+            magazine.head = ret->next;
+            --magazine.count;
+            magazine.lock.unlock();
+            return ret;
+        }
+
+        // Refill the magazine from the shared list.
         m_lock.lock();
+        ret = m_head;
+        if (ret != nullptr) [[likely]] {
+            Node* last = ret;
+            for (size_t i = 1; i < MagazineSize && last->next != nullptr; ++i) {
+                last = last->next;
+                ++magazine.count;
+            }
+            m_head = last->next;
+            magazine.head = last != ret ? ret->next : nullptr;
+            last->next = nullptr;
+        }
+        m_lock.unlock();
+        magazine.lock.unlock();
 
-        Node* ret = m_head;
         if (ret != nullptr) [[likely]] {
-            m_head = ret->next;
+            return ret;
         }
 
-        m_lock.unlock();
-        return ret;
+        // The shared list is empty, take an object cached by another thread.
+        return this->StealFromMagazines();
     }
 
     void Free(void* obj) {
         // KScopedInterruptDisable di;
 
-        m_lock.lock();
+        Magazine& magazine = m_magazines[GetMagazineIndex()];
+        magazine.lock.lock();
 
         Node* node = static_cast<Node*>(obj);
-        node->next = m_head;
-        m_head = node;
+        node->next = magazine.head;
+        magazine.head = node;
+
+        // Return a batch to the shared list when the magazine is full.
+        if (++magazine.count >= 2 * MagazineSize) {
+            Node* last = magazine.head;
+            for (size_t i = 1; i < MagazineSize; ++i) {
+                last = last->next;
+            }
+            Node* const first = magazine.head;
+            magazine.head = last->next;
+            magazine.count -= MagazineSize;
+
+            m_lock.lock();
+            last->next = m_head;
+            m_head = first;
+            m_lock.unlock();
+        }
 
-        m_lock.unlock();
+        magazine.lock.unlock();
+    }
+
+private:
+    struct alignas(64) Magazine {
+        Common::SpinLock lock;
+        Node* head{};
+        size_t count{};
+    };
+
+    static size_t GetMagazineIndex() {
+        static std::atomic<size_t> next_index{};
+        thread_local const size_t index =
+            next_index.fetch_add(1, std::memory_order_relaxed) % NumMagazines;
+        return index;
+    }
+
+    Node* StealFromMagazines() {
+        for (Magazine& magazine : m_magazines) {
+            magazine.lock.lock();
+            Node* const ret = magazine.head;
+            if (ret != nullptr) {
+                magazine.head = ret->next;
+                --magazine.count;
+            }
+            magazine.lock.unlock();
+            if (ret != nullptr) {
+                return ret;
+            }
+        }
+        return nullptr;
     }
 
 private:
     std::atomic<Node*> m_head{};
     Common::SpinLock m_lock;
+    std::array<Magazine, NumMagazines> m_magazines{};
 };
 
 } // namespace impl
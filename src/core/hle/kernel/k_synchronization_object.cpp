@@ -75,13 +75,20 @@ void KSynchronizationObject::Finalize() {
 Result KSynchronizationObject::Wait(KernelCore& kernel, s32* out_index,
                                     KSynchronizationObject** objects, const s32 num_objects,
                                     s64 timeout) {
-    // Allocate space on stack for thread nodes.
-    std::array<ThreadListNode, Svc::ArgumentHandleCountMax> thread_nodes;
+    // Allocate space on stack for thread nodes. Guest waits are limited to ArgumentHandleCountMax
+    // objects, only HLE servers waiting on the objects of many servers at once use the heap.
+    std::array<ThreadListNode, Svc::ArgumentHandleCountMax> stack_thread_nodes;
+    std::vector<ThreadListNode> heap_thread_nodes;
+    ThreadListNode* thread_nodes = stack_thread_nodes.data();
+    if (num_objects > Svc::ArgumentHandleCountMax) {
+        heap_thread_nodes.resize(num_objects);
+        thread_nodes = heap_thread_nodes.data();
+    }
 
     // Prepare for wait.
     KThread* thread = GetCurrentThreadPointer(kernel);
     KHardwareTimer* timer{};
-    ThreadQueueImplForKSynchronizationObjectWait wait_queue(kernel, objects, thread_nodes.data(),
+    ThreadQueueImplForKSynchronizationObjectWait wait_queue(kernel, objects, thread_nodes,
                                                             num_objects);
 
     {
@@ -530,6 +530,10 @@ public:
         return this->GetStackParameters().is_calling_svc;
     }
 
+    void SetSvcId(u8 svc_id) {
+        this->GetStackParameters().current_svc_id = svc_id;
+    }
+
     u8 GetSvcId() const {
         return this->GetStackParameters().current_svc_id;
     }
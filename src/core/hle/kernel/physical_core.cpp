@@ -133,8 +133,14 @@ void PhysicalCore::RunThread(Kernel::KThread* thread) {
 
         // Handle system calls.
         if (supervisor_call) {
+            // Note which call the thread is in, for the scheduler lock profiler.
+            const u32 svc_number = interface->GetSvcNumber();
+            thread->SetSvcId(static_cast<u8>(svc_number));
+            thread->SetIsCallingSvc();
+
             // Perform call.
-            Svc::Call(system, interface->GetSvcNumber());
+            Svc::Call(system, svc_number);
+            thread->ClearIsCallingSvc();
             return;
         }
 
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/microprofile.h"
+#include "core/hle/kernel/k_thread.h"
+#include "core/hle/kernel/scheduler_lock_profiler.h"
+
+MICROPROFILE_DEFINE(Kernel_SchedulerLockWait, "Kernel", "Scheduler Lock Wait",
+                    MP_RGB(200, 70, 70));
+MICROPROFILE_DEFINE(Kernel_SchedulerLockHold, "Kernel", "Scheduler Lock Hold",
+                    MP_RGB(200, 140, 70));
+
+namespace Kernel {
+
+namespace {
+// The lock is taken and released on the same host thread, it can't switch fibers while held.
+thread_local u64 wait_ticks{};
+thread_local u64 hold_ticks{};
+
+u64 GetTimeNs() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count());
+}
+
+u8 GetSvcId(const KThread* thread) {
+    if (thread == nullptr || !thread->IsCallingSvc()) {
+        return 0;
+    }
+    return static_cast<u8>(thread->GetSvcId() % SchedulerLockProfiler::NumSvcIds);
+}
+
+std::string FormatNs(u64 ns) {
+    if (ns < 10'000) {
+        return fmt::format("{}ns", ns);
+    }
+    if (ns < 10'000'000) {
+        return fmt::format("{}us", ns / 1'000);
+    }
+    return fmt::format("{}ms", ns / 1'000'000);
+}
+
+std::string FormatHistogram(const SchedulerLockProfiler::Histogram& histogram) {
+    if (histogram.count == 0) {
+        return "-";
+    }
+    return fmt::format("avg {:>7} p50 {:>7} p99 {:>7} max {:>7}",
+                       FormatNs(histogram.total_ns / histogram.count),
+                       FormatNs(histogram.GetPercentile(0.5)),
+                       FormatNs(histogram.GetPercentile(0.99)), FormatNs(histogram.max_ns));
+}
+} // Anonymous namespace
+
+u64 SchedulerLockProfiler::Histogram::GetPercentile(double percentile) const {
+    const u64 target = std::max<u64>(static_cast<u64>(static_cast<double>(count) * percentile), 1);
+    u64 sum = 0;
+    for (size_t i = 0; i < NumBuckets; ++i) {
+        sum += buckets[i];
+        if (sum >= target) {
+            return std::min(u64{1} << i, max_ns);
+        }
+    }
+    return max_ns;
+}
+
+void SchedulerLockProfiler::AtomicHistogram::Record(u64 ns) {
+    const size_t bucket = std::min<size_t>(std::bit_width(ns), NumBuckets - 1);
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(ns, std::memory_order_relaxed);
+
+    u64 current_max = max_ns.load(std::memory_order_relaxed);
+    while (current_max < ns &&
+           !max_ns.compare_exchange_weak(current_max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+SchedulerLockProfiler::Histogram SchedulerLockProfiler::AtomicHistogram::Load() const {
+    Histogram histogram{};
+    for (size_t i = 0; i < NumBuckets; ++i) {
+        histogram.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+    histogram.count = count.load(std::memory_order_relaxed);
+    histogram.total_ns = total_ns.load(std::memory_order_relaxed);
+    histogram.max_ns = max_ns.load(std::memory_order_relaxed);
+    return histogram;
+}
+
+void SchedulerLockProfiler::AtomicHistogram::Reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    total_ns.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+}
+
+u64 SchedulerLockProfiler::BeginWait() {
+    wait_ticks = MicroProfileEnter(MICROPROFILE_TOKEN(Kernel_SchedulerLockWait));
+    return GetTimeNs();
+}
+
+u64 SchedulerLockProfiler::EndWait(u64 wait_start, const KThread* thread) {
+    const u64 now = GetTimeNs();
+    MicroProfileLeave(MICROPROFILE_TOKEN(Kernel_SchedulerLockWait), wait_ticks);
+    m_wait[GetSvcId(thread)].Record(now - wait_start);
+
+    hold_ticks = MicroProfileEnter(MICROPROFILE_TOKEN(Kernel_SchedulerLockHold));
+    return now;
+}
+
+void SchedulerLockProfiler::EndHold(u64 hold_start, const KThread* thread) {
+    m_hold[GetSvcId(thread)].Record(GetTimeNs() - hold_start);
+    MicroProfileLeave(MICROPROFILE_TOKEN(Kernel_SchedulerLockHold), hold_ticks);
+}
+
+SchedulerLockProfiler::Histogram SchedulerLockProfiler::GetWaitHistogram(u8 svc_id) const {
+    return m_wait[svc_id % NumSvcIds].Load();
+}
+
+SchedulerLockProfiler::Histogram SchedulerLockProfiler::GetHoldHistogram(u8 svc_id) const {
+    return m_hold[svc_id % NumSvcIds].Load();
+}
+
+void SchedulerLockProfiler::Reset() {
+    for (size_t i = 0; i < NumSvcIds; ++i) {
+        m_wait[i].Reset();
+        m_hold[i].Reset();
+    }
+}
+
+std::string SchedulerLockProfiler::Dump() const {
+    struct Entry {
+        u8 svc_id;
+        Histogram wait;
+        Histogram hold;
+    };
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < NumSvcIds; ++i) {
+        const auto svc_id = static_cast<u8>(i);
+        Entry entry{svc_id, GetWaitHistogram(svc_id), GetHoldHistogram(svc_id)};
+        if (entry.wait.count != 0 || entry.hold.count != 0) {
+            entries.push_back(entry);
+        }
+    }
+    std::ranges::sort(entries, std::ranges::greater{},
+                      [](const Entry& entry) { return entry.hold.total_ns; });
+
+    std::string reply = "Scheduler lock, by SVC:\n";
+    for (const Entry& entry : entries) {
+        const std::string name =
+            entry.svc_id == 0 ? std::string{"none"} : fmt::format("{:#04x}", entry.svc_id);
+        reply += fmt::format("  {:<4} {:>10} locks, {:>9} held\n", name, entry.hold.count,
+                             FormatNs(entry.hold.total_ns));
+        reply += fmt::format("    wait: {}\n", FormatHistogram(entry.wait));
+        reply += fmt::format("    hold: {}\n", FormatHistogram(entry.hold));
+    }
+    return reply;
+}
+
+} // namespace Kernel
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace Kernel {
+
+class KThread;
+
+/**
+ * Records how long the scheduler lock is waited on and held, per SVC of the thread taking it.
+ *
+ * Profiling is opt-in, a disabled profiler costs the lock a single relaxed load. Times are kept
+ * in histograms with power of two buckets, the waits and holds also show up in microprofile.
+ */
+class SchedulerLockProfiler {
+public:
+    /// Number of histogram buckets, the last one holds all times of 2^(NumBuckets - 1) ns or more.
+    static constexpr size_t NumBuckets = 28;
+
+    /// Number of SVC ids. Zero is not a valid SVC, it records the lock taken outside of SVCs.
+    static constexpr size_t NumSvcIds = 0x80;
+
+    struct Histogram {
+        std::array<u64, NumBuckets> buckets;
+        u64 count;
+        u64 total_ns;
+        u64 max_ns;
+
+        /// Returns an upper bound of the given percentile, in nanoseconds.
+        u64 GetPercentile(double percentile) const;
+    };
+
+    SchedulerLockProfiler() = default;
+
+    SUYU_NON_COPYABLE(SchedulerLockProfiler);
+    SUYU_NON_MOVEABLE(SchedulerLockProfiler);
+
+    bool IsEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    /// Called before waiting on the lock, returns the wait start time.
+    u64 BeginWait();
+
+    /// Called once thread took the lock, returns the hold start time.
+    u64 EndWait(u64 wait_start, const KThread* thread);
+
+    /// Called before thread releases the lock.
+    void EndHold(u64 hold_start, const KThread* thread);
+
+    Histogram GetWaitHistogram(u8 svc_id) const;
+    Histogram GetHoldHistogram(u8 svc_id) const;
+
+    /// Clears all recorded times.
+    void Reset();
+
+    /// Formats the recorded times of every SVC that took the lock, most held first.
+    std::string Dump() const;
+
+private:
+    struct AtomicHistogram {
+        std::array<std::atomic<u64>, NumBuckets> buckets{};
+        std::atomic<u64> count{};
+        std::atomic<u64> total_ns{};
+        std::atomic<u64> max_ns{};
+
+        void Record(u64 ns);
+        Histogram Load() const;
+        void Reset();
+    };
+
+    std::atomic<bool> m_enabled{};
+    std::array<AtomicHistogram, NumSvcIds> m_wait{};
+    std::array<AtomicHistogram, NumSvcIds> m_hold{};
+};
+
+} // namespace Kernel
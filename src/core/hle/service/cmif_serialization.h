@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "common/div_ceil.h"
 
 #include "core/hle/service/cmif_types.h"
@@ -239,7 +241,7 @@ constexpr RequestLayout GetReplyOutLayout(bool is_domain) {
     return is_domain ? GetDomainReplyOutLayout<MethodArguments>() : GetNonDomainReplyOutLayout<MethodArguments>();
 }
 
-using OutTemporaryBuffers = std::array<Common::ScratchBuffer<u8>, 3>;
+using OutTemporaryBuffers = std::array<std::optional<WriteBufferView>, 3>;
 
 template <typename MethodArguments, typename CallArguments, size_t PrevAlign = 1, size_t DataOffset = 0, size_t HandleIndex = 0, size_t InBufferIndex = 0, size_t OutBufferIndex = 0, bool RawDataFinished = false, size_t ArgIndex = 0>
 void ReadInArgument(bool is_domain, CallArguments& args, const u8* raw_data, HLERequestContext& ctx, OutTemporaryBuffers& temp) {
@@ -338,13 +340,11 @@ void ReadInArgument(bool is_domain, CallArguments& args, const u8* raw_data, HLE
         } else if constexpr (ArgumentTraits<ArgType>::Type == ArgumentType::OutBuffer) {
             using ElementType = typename ArgType::Type;
 
-            // Set up scratch buffer.
-            auto& buffer = temp[OutBufferIndex];
-            if (ctx.CanWriteBuffer(OutBufferIndex)) {
-                buffer.resize_destructive(ctx.GetWriteBufferSize(OutBufferIndex));
-            } else {
-                buffer.resize_destructive(0);
-            }
+            // Set up a view of the buffer, it's written in place when possible.
+            constexpr auto ViewType = (ArgType::Attr & BufferAttr_HipcAutoSelect) ? WriteBufferView::Type::AutoSelect
+                                    : (ArgType::Attr & BufferAttr_HipcMapAlias)   ? WriteBufferView::Type::B
+                                                                                  : WriteBufferView::Type::C;
+            auto& buffer = temp[OutBufferIndex].emplace(ctx, OutBufferIndex, ViewType);
 
             ElementType* ptr = (ElementType*) buffer.data();
             size_t size = buffer.size() / sizeof(ElementType);
@@ -412,18 +412,8 @@ void WriteOutArgument(bool is_domain, CallArguments& args, u8* raw_data, HLERequ
 
             return WriteOutArgument<MethodArguments, CallArguments, PrevAlign, DataOffset, OutBufferIndex + 1, RawDataFinished, ArgIndex + 1>(is_domain, args, raw_data, ctx, temp);
         } else if constexpr (ArgumentTraits<ArgType>::Type == ArgumentType::OutBuffer) {
-            auto& buffer = temp[OutBufferIndex];
-            const size_t size = buffer.size();
-
-            if (size > 0 && ctx.CanWriteBuffer(OutBufferIndex)) {
-                if constexpr (ArgType::Attr & BufferAttr_HipcAutoSelect) {
-                    ctx.WriteBuffer(buffer.data(), size, OutBufferIndex);
-                } else if constexpr (ArgType::Attr & BufferAttr_HipcMapAlias) {
-                    ctx.WriteBufferB(buffer.data(), size, OutBufferIndex);
-                } else /* if (ArgType::Attr & BufferAttr_HipcPointer) */ {
-                    ctx.WriteBufferC(buffer.data(), size, OutBufferIndex);
-                }
-            }
+            // Commit the buffer to guest memory.
+            temp[OutBufferIndex].reset();
 
             return WriteOutArgument<MethodArguments, CallArguments, PrevAlign, DataOffset, OutBufferIndex + 1, RawDataFinished, ArgIndex + 1>(is_domain, args, raw_data, ctx, temp);
         } else {
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Service {
+
+/**
+ * Maps the command ids of an interface to the index of their handler.
+ *
+ * Interfaces mostly use small, dense command ids, those index a table directly. The larger ids
+ * some interfaces use, like the 10000+ ranges, are looked up in a sorted vector.
+ */
+class CommandTable {
+public:
+    /// Command ids below this value are indexed directly.
+    static constexpr u32 MaxDirectId = 2048;
+
+    /// Maps id to index, unless id is already mapped.
+    void Insert(u32 id, u16 index) {
+        if (id < MaxDirectId) {
+            if (id >= direct.size()) {
+                direct.resize(id + 1, Invalid);
+            }
+            if (direct[id] == Invalid) {
+                direct[id] = index;
+            }
+            return;
+        }
+        const auto it = std::ranges::lower_bound(sparse, id, {}, &std::pair<u32, u16>::first);
+        if (it == sparse.end() || it->first != id) {
+            sparse.emplace(it, id, index);
+        }
+    }
+
+    /// Returns the index mapped to id, if any.
+    [[nodiscard]] std::optional<u16> Find(u32 id) const {
+        if (id < direct.size()) [[likely]] {
+            const u16 index = direct[id];
+            return index != Invalid ? std::optional{index} : std::nullopt;
+        }
+        const auto it = std::ranges::lower_bound(sparse, id, {}, &std::pair<u32, u16>::first);
+        if (it == sparse.end() || it->first != id) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+private:
+    static constexpr u16 Invalid = std::numeric_limits<u16>::max();
+
+    std::vector<u16> direct;
+    std::vector<std::pair<u32, u16>> sparse;
+};
+
+} // namespace Service
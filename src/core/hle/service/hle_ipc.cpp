@@ -505,6 +505,19 @@ bool HLERequestContext::CanWriteBuffer(std::size_t buffer_index) const {
     }
 }
 
+bool HLERequestContext::OverlapsOtherBuffers(VAddr address, std::size_t size,
+                                             const void* descriptor) const {
+    const auto overlaps = [&](const auto& other) {
+        return static_cast<const void*>(&other) != descriptor && other.Size() != 0 &&
+               other.Address() < address + size && address < other.Address() + other.Size();
+    };
+    return std::ranges::any_of(BufferDescriptorA(), overlaps) ||
+           std::ranges::any_of(BufferDescriptorX(), overlaps) ||
+           std::ranges::any_of(BufferDescriptorB(), overlaps) ||
+           std::ranges::any_of(buffer_w_descriptors, overlaps) ||
+           std::ranges::any_of(BufferDescriptorC(), overlaps);
+}
+
 void HLERequestContext::AddMoveInterface(SessionRequestHandlerPtr s) {
     ASSERT(Kernel::GetCurrentProcess(kernel).GetResourceLimit()->Reserve(
         Kernel::LimitableResource::SessionCountMax, 1));
@@ -572,4 +585,47 @@ std::string HLERequestContext::Description() const {
     return s.str();
 }
 
+WriteBufferView::WriteBufferView(const HLERequestContext& ctx, std::size_t buffer_index,
+                                 Type type) {
+    if (type == Type::AutoSelect) {
+        const bool is_buffer_b{ctx.BufferDescriptorB().size() > buffer_index &&
+                               ctx.BufferDescriptorB()[buffer_index].Size()};
+        type = is_buffer_b ? Type::B : Type::C;
+    }
+
+    VAddr address{};
+    std::size_t size{};
+    const void* descriptor{};
+    if (type == Type::B) {
+        if (buffer_index >= ctx.BufferDescriptorB().size()) {
+            return;
+        }
+        descriptor = &ctx.BufferDescriptorB()[buffer_index];
+        address = ctx.BufferDescriptorB()[buffer_index].Address();
+        size = ctx.BufferDescriptorB()[buffer_index].Size();
+    } else {
+        if (buffer_index >= ctx.BufferDescriptorC().size()) {
+            return;
+        }
+        descriptor = &ctx.BufferDescriptorC()[buffer_index];
+        address = ctx.BufferDescriptorC()[buffer_index].Address();
+        size = ctx.BufferDescriptorC()[buffer_index].Size();
+    }
+    if (size == 0) {
+        return;
+    }
+
+    auto& scratch = ctx.write_buffer_data[buffer_index];
+    guest_memory.emplace(ctx.GetMemory(), address, size, &scratch);
+    // Writing in place is only safe when the service can't observe it through another buffer,
+    // an input buffer or another output view of the same request.
+    if (ctx.OverlapsOtherBuffers(address, size, descriptor)) {
+        guest_memory->SetDataCopy(&scratch);
+    }
+    span = std::span(guest_memory->data(), size);
+}
+
+// Written back or invalidated for the GPU by the guest memory, like WriteBlock does.
+WriteBufferView::~WriteBufferView() = default;
+
 } // namespace Service
@@ -13,19 +13,18 @@
 #include <vector>
 
 #include "common/assert.h"
+#include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/concepts.h"
+#include "common/scratch_buffer.h"
 #include "common/swap.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/k_handle_table.h"
 #include "core/hle/kernel/svc_common.h"
+#include "core/memory.h"
 
 union Result;
 
-namespace Core::Memory {
-class Memory;
-}
-
 namespace IPC {
 class ResponseBuilder;
 }
@@ -391,6 +390,11 @@ public:
 
 private:
     friend class IPC::ResponseBuilder;
+    friend class WriteBufferView;
+
+    /// Returns true if the range overlaps a buffer of the request other than `descriptor`.
+    [[nodiscard]] bool OverlapsOtherBuffers(VAddr address, std::size_t size,
+                                            const void* descriptor) const;
 
     void ParseCommandBuffer(u32_le* src_cmdbuf, bool incoming);
 
@@ -431,6 +435,49 @@ private:
 
     mutable std::array<Common::ScratchBuffer<u8>, 3> read_buffer_data_a{};
     mutable std::array<Common::ScratchBuffer<u8>, 3> read_buffer_data_x{};
+    mutable std::array<Common::ScratchBuffer<u8>, 3> write_buffer_data{};
+};
+
+/**
+ * Writable view of an output buffer of a request, to fill it without an intermediate copy.
+ *
+ * The view refers to guest memory directly when the buffer is contiguous in host memory and
+ * doesn't overlap any other buffer of the request. Otherwise it refers to a scratch buffer of the
+ * request, written to guest memory when the view is destroyed.
+ */
+class WriteBufferView {
+public:
+    enum class Type {
+        AutoSelect, ///< Buffer descriptor B, or C when B is empty, like WriteBuffer
+        B,
+        C,
+    };
+
+    explicit WriteBufferView(const HLERequestContext& ctx, std::size_t buffer_index = 0,
+                             Type type = Type::AutoSelect);
+    ~WriteBufferView();
+
+    SUYU_NON_COPYABLE(WriteBufferView);
+    SUYU_NON_MOVEABLE(WriteBufferView);
+
+    [[nodiscard]] std::span<u8> Span() const noexcept {
+        return span;
+    }
+
+    [[nodiscard]] u8* data() const noexcept {
+        return span.data();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return span.size();
+    }
+
+private:
+    using GuestMemory =
+        Core::Memory::CpuGuestMemoryScoped<u8, Core::Memory::GuestMemoryFlags::SafeWrite>;
+
+    std::optional<GuestMemory> guest_memory;
+    std::span<u8> span;
 };
 
 } // namespace Service
@@ -2,6 +2,8 @@
 // SPDX-FileCopyrightText: 2021 Skyline Team and Contributors
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <optional>
+
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
@@ -16,6 +18,20 @@
 
 namespace Service::Nvidia {
 
+namespace {
+// Returns the buffer the ioctl writes its output to. Outputs returned to the guest are written in
+// place when possible, the others go to the scratch buffer and are dropped.
+std::span<u8> GetOutputBuffer(HLERequestContext& ctx, Ioctl command, std::size_t buffer_index,
+                              std::optional<WriteBufferView>& view,
+                              Common::ScratchBuffer<u8>& scratch) {
+    if (command.is_out != 0) {
+        return view.emplace(ctx, buffer_index).Span();
+    }
+    scratch.resize_destructive(ctx.GetWriteBufferSize(buffer_index));
+    return scratch;
+}
+} // Anonymous namespace
+
 void NVDRV::Open(HLERequestContext& ctx) {
     LOG_DEBUG(Service_NVDRV, "called");
     IPC::ResponseBuilder rb{ctx, 4};
@@ -65,13 +81,11 @@ void NVDRV::Ioctl1(HLERequestContext& ctx) {
     }
 
     // Check device
-    output_buffer.resize_destructive(ctx.GetWriteBufferSize(0));
+    std::optional<WriteBufferView> output_view;
+    const auto output = GetOutputBuffer(ctx, command, 0, output_view, output_buffer);
     const auto input_buffer = ctx.ReadBuffer(0);
 
-    const auto nv_result = nvdrv->Ioctl1(fd, command, input_buffer, output_buffer);
-    if (command.is_out != 0) {
-        ctx.WriteBuffer(output_buffer);
-    }
+    const auto nv_result = nvdrv->Ioctl1(fd, command, input_buffer, output);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(ResultSuccess);
@@ -92,13 +106,10 @@ void NVDRV::Ioctl2(HLERequestContext& ctx) {
 
     const auto input_buffer = ctx.ReadBuffer(0);
     const auto input_inlined_buffer = ctx.ReadBuffer(1);
-    output_buffer.resize_destructive(ctx.GetWriteBufferSize(0));
+    std::optional<WriteBufferView> output_view;
+    const auto output = GetOutputBuffer(ctx, command, 0, output_view, output_buffer);
 
-    const auto nv_result =
-        nvdrv->Ioctl2(fd, command, input_buffer, input_inlined_buffer, output_buffer);
-    if (command.is_out != 0) {
-        ctx.WriteBuffer(output_buffer);
-    }
+    const auto nv_result = nvdrv->Ioctl2(fd, command, input_buffer, input_inlined_buffer, output);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(ResultSuccess);
@@ -118,15 +129,13 @@ void NVDRV::Ioctl3(HLERequestContext& ctx) {
     }
 
     const auto input_buffer = ctx.ReadBuffer(0);
-    output_buffer.resize_destructive(ctx.GetWriteBufferSize(0));
-    inline_output_buffer.resize_destructive(ctx.GetWriteBufferSize(1));
+    std::optional<WriteBufferView> output_view;
+    std::optional<WriteBufferView> inline_output_view;
+    const auto output = GetOutputBuffer(ctx, command, 0, output_view, output_buffer);
+    const auto inline_output =
+        GetOutputBuffer(ctx, command, 1, inline_output_view, inline_output_buffer);
 
-    const auto nv_result =
-        nvdrv->Ioctl3(fd, command, input_buffer, output_buffer, inline_output_buffer);
-    if (command.is_out != 0) {
-        ctx.WriteBuffer(output_buffer, 0);
-        ctx.WriteBuffer(inline_output_buffer, 1);
-    }
+    const auto nv_result = nvdrv->Ioctl3(fd, command, input_buffer, output, inline_output);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(ResultSuccess);
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <vector>
+
 #include "core/hle/kernel/k_hardware_timer.h"
 #include "core/hle/kernel/k_synchronization_object.h"
 #include "core/hle/kernel/kernel.h"
@@ -48,6 +50,29 @@ MultiWaitHolder* MultiWait::TimedWaitImpl(Kernel::KernelCore& kernel, s64 timeou
     }
 }
 
+MultiWaitHolder* MultiWait::WaitAny(Kernel::KernelCore& kernel,
+                                    std::span<MultiWait* const> multi_waits) {
+    std::vector<MultiWaitHolder*> holders;
+    std::vector<Kernel::KSynchronizationObject*> objects;
+
+    for (MultiWait* const multi_wait : multi_waits) {
+        for (auto it = multi_wait->m_wait_list.begin(); it != multi_wait->m_wait_list.end(); it++) {
+            holders.push_back(std::addressof(*it));
+            objects.push_back(it->GetNativeHandle());
+        }
+    }
+
+    s32 out_index = -1;
+    Kernel::KSynchronizationObject::Wait(kernel, std::addressof(out_index), objects.data(),
+                                         static_cast<s32>(objects.size()), -1);
+
+    if (out_index == -1) {
+        return nullptr;
+    } else {
+        return holders[out_index];
+    }
+}
+
 void MultiWait::MoveAll(MultiWait* other) {
     while (!other->m_wait_list.empty()) {
         MultiWaitHolder& holder = other->m_wait_list.front();
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "core/hle/service/os/multi_wait_holder.h"
 
 namespace Kernel {
@@ -22,6 +24,11 @@ public:
     MultiWaitHolder* TimedWaitAny(Kernel::KernelCore& kernel, s64 timeout_ns);
     // TODO: SdkReplyAndReceive?
 
+    /// Waits for any holder linked to any of the given multi waits, without the handle limit of
+    /// a single wait.
+    static MultiWaitHolder* WaitAny(Kernel::KernelCore& kernel,
+                                    std::span<MultiWait* const> multi_waits);
+
     void MoveAll(MultiWait* other);
 
 private:
@@ -33,6 +33,10 @@ public:
         return m_native_handle;
     }
 
+    MultiWait* GetMultiWait() const {
+        return m_multi_wait;
+    }
+
 private:
     friend class MultiWait;
     Common::IntrusiveListNode m_list_node{};
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "common/assert.h"
+#include "core/core.h"
+#include "core/hle/kernel/k_event.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/service/server_executor.h"
+#include "core/hle/service/server_manager.h"
+
+namespace Service {
+
+namespace {
+thread_local ServerExecutor* current_executor{};
+
+size_t GetNumWorkers() {
+    // Most servers are idle most of the time, a few workers are enough to keep up
+    return std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2, 8);
+}
+} // Anonymous namespace
+
+ServerExecutor::ServerExecutor(Core::System& system) : m_system{system} {
+    // Initialize event.
+    m_wakeup_event = Kernel::KEvent::Create(system.Kernel());
+    m_wakeup_event->Initialize(nullptr);
+
+    // Register event.
+    Kernel::KEvent::Register(system.Kernel(), m_wakeup_event);
+
+    // Link to holder.
+    m_wakeup_holder.emplace(std::addressof(m_wakeup_event->GetReadableEvent()));
+    m_wakeup_holder->LinkToMultiWait(std::addressof(m_multi_wait));
+
+    // Start the workers, each one in its own host process like the servers they replace.
+    const size_t num_workers = GetNumWorkers();
+    for (size_t i = 0; i < num_workers; i++) {
+        m_workers.push_back(system.Kernel().RunOnHostCoreProcess(
+            fmt::format("ServiceExecutor:{}", i),
+            [this, stop_token = m_stop_source.get_token()] { this->WorkerLoop(stop_token); }));
+    }
+}
+
+ServerExecutor::~ServerExecutor() {
+    // Signal stop.
+    m_stop_source.request_stop();
+    m_wakeup_event->Signal();
+
+    // Wait for the workers to exit.
+    m_workers.clear();
+    ASSERT(m_state.Empty());
+
+    // Close wakeup event.
+    m_wakeup_holder->UnlinkFromMultiWait();
+    m_wakeup_event->GetReadableEvent().Close();
+    m_wakeup_event->Close();
+}
+
+void ServerExecutor::Post(std::function<void()>&& func) {
+    {
+        std::scoped_lock lk{m_mutex};
+        m_tasks.push_back(std::move(func));
+    }
+    m_condition.notify_one();
+}
+
+ServerExecutor* ServerExecutor::GetCurrent() {
+    return current_executor;
+}
+
+void ServerExecutor::Adopt(ServerManager* manager) {
+    {
+        std::scoped_lock lk{m_mutex};
+        m_state.Adopt(manager);
+    }
+
+    // Make the waiting worker include the new server.
+    m_wakeup_event->Signal();
+}
+
+void ServerExecutor::Release(ServerManager* manager) {
+    std::unique_lock lk{m_mutex};
+    if (!m_state.BeginRelease(manager)) {
+        return;
+    }
+
+    // Make the waiting worker drop the server, and wait for requests in flight.
+    m_wakeup_event->Signal();
+    m_condition.wait(lk, [&] { return m_state.TryEndRelease(manager); });
+}
+
+void ServerExecutor::WorkerLoop(std::stop_token stop_token) {
+    current_executor = this;
+
+    std::unique_lock lk{m_mutex};
+    while (!stop_token.stop_requested()) {
+        // Run posted work first, it's only used to start servers.
+        if (!m_tasks.empty()) {
+            auto task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            lk.unlock();
+            task();
+            lk.lock();
+            continue;
+        }
+
+        // Park while another worker waits for requests.
+        if (m_has_waiter) {
+            m_condition.wait(lk, stop_token, [&] { return !m_has_waiter || !m_tasks.empty(); });
+            continue;
+        }
+
+        this->WaitAndProcess(lk);
+    }
+}
+
+void ServerExecutor::WaitAndProcess(std::unique_lock<std::mutex>& lk) {
+    // Collect the servers that can take a request.
+    const std::vector<ServerManager*> managers = m_state.BeginWait();
+    std::vector<MultiWait*> multi_waits{std::addressof(m_multi_wait)};
+    for (ServerManager* const manager : managers) {
+        manager->LinkDeferred();
+        multi_waits.push_back(std::addressof(manager->m_multi_wait));
+    }
+    m_has_waiter = true;
+
+    lk.unlock();
+    auto* const selected = MultiWait::WaitAny(m_system.Kernel(), multi_waits);
+    lk.lock();
+
+    // Hand the wait over to the next idle worker.
+    m_state.EndWait();
+    m_has_waiter = false;
+    m_condition.notify_all();
+
+    if (selected == nullptr) {
+        return;
+    }
+    if (selected == std::addressof(*m_wakeup_holder)) {
+        // Clear and restart if we were woken up.
+        m_wakeup_event->Clear();
+        return;
+    }
+
+    // The lock was held since the wait ended, so none of the servers was released meanwhile.
+    const auto it = std::ranges::find_if(managers, [&](const ServerManager* manager) {
+        return selected->GetMultiWait() == std::addressof(manager->m_multi_wait);
+    });
+    ASSERT(it != managers.end());
+    ServerManager* const manager = *it;
+    if (selected == std::addressof(*manager->m_wakeup_holder)) {
+        // Clear and restart if the server was woken up.
+        manager->m_wakeup_event->Clear();
+        return;
+    }
+
+    // Unlink the event, the server links it again once it's done with it.
+    selected->UnlinkFromMultiWait();
+    if (!m_state.BeginProcess(manager)) {
+        return;
+    }
+
+    lk.unlock();
+    R_ASSERT(manager->Process(selected));
+    lk.lock();
+
+    m_state.EndProcess(manager);
+    m_condition.notify_all();
+
+    // Make the waiting worker include the server again.
+    m_wakeup_event->Signal();
+}
+
+} // namespace Service
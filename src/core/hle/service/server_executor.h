@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "common/common_funcs.h"
+#include "common/polyfill_thread.h"
+#include "core/hle/service/server_executor_state.h"
+#include "core/hle/service/os/multi_wait.h"
+
+namespace Core {
+class System;
+}
+
+namespace Kernel {
+class KEvent;
+}
+
+namespace Service {
+
+class ServerManager;
+
+/**
+ * Runs host servers on a small shared pool of host threads, instead of one thread per server.
+ *
+ * One worker at a time waits on the ports and sessions of every server, the other idle workers
+ * park on a condition variable. The worker that receives a request wakes the next one to take over
+ * the wait before processing it. A server processes one request at a time, like on its own thread.
+ */
+class ServerExecutor {
+public:
+    explicit ServerExecutor(Core::System& system);
+    ~ServerExecutor();
+
+    SUYU_NON_COPYABLE(ServerExecutor);
+    SUYU_NON_MOVEABLE(ServerExecutor);
+
+    /// Runs func on a worker. Servers it starts with ServerManager::RunServer join the executor.
+    void Post(std::function<void()>&& func);
+
+    /// Returns the executor of the calling thread, or nullptr if it isn't an executor worker.
+    [[nodiscard]] static ServerExecutor* GetCurrent();
+
+    /// Starts serving requests of the given server.
+    void Adopt(ServerManager* manager);
+
+    /// Stops serving requests of the given server, waits for the ones in flight.
+    void Release(ServerManager* manager);
+
+private:
+    void WorkerLoop(std::stop_token stop_token);
+
+    void WaitAndProcess(std::unique_lock<std::mutex>& lock);
+
+    Core::System& m_system;
+
+    Kernel::KEvent* m_wakeup_event{};
+    MultiWait m_multi_wait{};
+    std::optional<MultiWaitHolder> m_wakeup_holder{};
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    ServerExecutorState<ServerManager> m_state;
+    bool m_has_waiter{};
+
+    std::stop_source m_stop_source;
+    std::vector<std::jthread> m_workers;
+};
+
+} // namespace Service
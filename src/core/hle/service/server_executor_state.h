@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+namespace Service {
+
+/**
+ * Tracks the servers of a ServerExecutor, and whether a worker waits on or processes each of
+ * them. It doesn't synchronize on its own, the executor calls it with its mutex held.
+ *
+ * A server is processed by one worker at a time, like on its own thread. It's only removed once
+ * no worker refers to it anymore, so its ServerManager can be destroyed right after Release.
+ */
+template <typename Server>
+class ServerExecutorState {
+public:
+    void Adopt(Server* server) {
+        m_servers.push_back(Entry{.server = server});
+    }
+
+    /// Excludes the server from future waits, returns false if it isn't adopted.
+    bool BeginRelease(Server* server) {
+        const auto it = this->Find(server);
+        if (it == m_servers.end()) {
+            return false;
+        }
+        it->is_releasing = true;
+        return true;
+    }
+
+    /// Removes a releasing server once no worker waits on or processes it anymore.
+    bool TryEndRelease(Server* server) {
+        const auto it = this->Find(server);
+        if (it->is_waited || it->is_active) {
+            return false;
+        }
+        m_servers.erase(it);
+        return true;
+    }
+
+    /// Returns the servers that can take a request, they stay referenced until EndWait.
+    std::vector<Server*> BeginWait() {
+        std::vector<Server*> servers;
+        for (Entry& entry : m_servers) {
+            if (entry.is_releasing || entry.is_active) {
+                continue;
+            }
+            entry.is_waited = true;
+            servers.push_back(entry.server);
+        }
+        return servers;
+    }
+
+    void EndWait() {
+        for (Entry& entry : m_servers) {
+            entry.is_waited = false;
+        }
+    }
+
+    /// Marks the server as processing a request, returns false if it's being released.
+    bool BeginProcess(Server* server) {
+        const auto it = this->Find(server);
+        if (it->is_releasing) {
+            return false;
+        }
+        it->is_active = true;
+        return true;
+    }
+
+    void EndProcess(Server* server) {
+        this->Find(server)->is_active = false;
+    }
+
+    bool Contains(Server* server) {
+        return this->Find(server) != m_servers.end();
+    }
+
+    bool Empty() const {
+        return m_servers.empty();
+    }
+
+private:
+    struct Entry {
+        Server* server;
+        bool is_waited{};
+        bool is_active{};
+        bool is_releasing{};
+    };
+
+    typename std::list<Entry>::iterator Find(Server* server) {
+        return std::ranges::find(m_servers, server, &Entry::server);
+    }
+
+    std::list<Entry> m_servers;
+};
+
+} // namespace Service
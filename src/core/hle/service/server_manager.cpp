@@ -15,6 +15,7 @@
 #include "core/hle/kernel/svc_results.h"
 #include "core/hle/service/hle_ipc.h"
 #include "core/hle/service/ipc_helpers.h"
+#include "core/hle/service/server_executor.h"
 #include "core/hle/service/server_manager.h"
 #include "core/hle/service/sm/sm.h"
 
@@ -89,7 +90,11 @@ ServerManager::~ServerManager() {
     m_wakeup_event->Signal();
 
     // Wait for processing to stop.
-    m_stopped.Wait();
+    if (m_executor) {
+        m_executor->Release(this);
+    } else {
+        m_stopped.Wait();
+    }
     m_threads.clear();
 
     // Clean up ports.
@@ -119,6 +124,8 @@ ServerManager::~ServerManager() {
 }
 
 void ServerManager::RunServer(std::unique_ptr<ServerManager>&& server_manager) {
+    // Servers started by an executor worker are served by the executor instead of this thread.
+    server_manager->m_executor = ServerExecutor::GetCurrent();
     server_manager->m_system.RunServer(std::move(server_manager));
 }
 
@@ -235,6 +242,10 @@ Result ServerManager::ManageDeferral(Kernel::KEvent** out_event) {
 }
 
 void ServerManager::StartAdditionalHostThreads(const char* name, size_t num_threads) {
+    // The executor serves a server from one worker at a time, it can't host these threads.
+    ASSERT_MSG(ServerExecutor::GetCurrent() == nullptr,
+               "Servers with additional threads must not be started on the executor");
+
     for (size_t i = 0; i < num_threads; i++) {
         auto thread_name = fmt::format("{}:{}", name, i + 1);
         m_threads.emplace_back(m_system.Kernel().RunOnHostCoreThread(
@@ -243,6 +254,11 @@ void ServerManager::StartAdditionalHostThreads(const char* name, size_t num_thre
 }
 
 Result ServerManager::LoopProcess() {
+    if (m_executor) {
+        m_executor->Adopt(this);
+        R_SUCCEED();
+    }
+
     SCOPE_EXIT {
         m_stopped.Set();
     };
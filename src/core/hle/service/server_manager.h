@@ -28,6 +28,7 @@ class KServerSession;
 namespace Service {
 
 class Port;
+class ServerExecutor;
 class Session;
 
 class ServerManager {
@@ -53,6 +54,8 @@ public:
     static void RunServer(std::unique_ptr<ServerManager>&& server);
 
 private:
+    friend class ServerExecutor;
+
     void LinkToDeferredList(MultiWaitHolder* holder);
     void LinkDeferred();
     MultiWaitHolder* WaitSignaled();
@@ -92,6 +95,7 @@ private:
     Common::Event m_stopped{};
     std::vector<std::jthread> m_threads{};
     std::stop_source m_stop_source{};
+    ServerExecutor* m_executor{};
 };
 
 } // namespace Service
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <limits>
+
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -42,22 +44,28 @@ ServiceFrameworkBase::~ServiceFrameworkBase() {
     const auto guard = LockService();
 }
 
-void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n) {
-    handlers.reserve(handlers.size() + n);
+void ServiceFrameworkBase::RegisterHandlersImpl(std::vector<FunctionInfoBase>& out_handlers,
+                                                CommandTable& out_table,
+                                                const FunctionInfoBase* functions, std::size_t n) {
+    out_handlers.reserve(out_handlers.size() + n);
     for (std::size_t i = 0; i < n; ++i) {
-        // Usually this array is sorted by id already, so hint to insert at the end
-        handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
+        // The first handler registered for an id wins
+        if (out_table.Find(functions[i].expected_header)) {
+            continue;
+        }
+        ASSERT(out_handlers.size() < std::numeric_limits<u16>::max());
+        out_table.Insert(functions[i].expected_header, static_cast<u16>(out_handlers.size()));
+        out_handlers.push_back(functions[i]);
     }
 }
 
+void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n) {
+    RegisterHandlersImpl(handlers, handler_table, functions, n);
+}
+
 void ServiceFrameworkBase::RegisterHandlersBaseTipc(const FunctionInfoBase* functions,
                                                     std::size_t n) {
-    handlers_tipc.reserve(handlers_tipc.size() + n);
-    for (std::size_t i = 0; i < n; ++i) {
-        // Usually this array is sorted by id already, so hint to insert at the end
-        handlers_tipc.emplace_hint(handlers_tipc.cend(), functions[i].expected_header,
-                                   functions[i]);
-    }
+    RegisterHandlersImpl(handlers_tipc, handler_table_tipc, functions, n);
 }
 
 void ServiceFrameworkBase::ReportUnimplementedFunction(HLERequestContext& ctx,
@@ -83,9 +91,11 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(HLERequestContext& ctx,
     }
 }
 
-void ServiceFrameworkBase::InvokeRequest(HLERequestContext& ctx) {
-    auto itr = handlers.find(ctx.GetCommand());
-    const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
+void ServiceFrameworkBase::InvokeHandler(HLERequestContext& ctx,
+                                         const std::vector<FunctionInfoBase>& functions,
+                                         const CommandTable& table) {
+    const auto index = table.Find(ctx.GetCommand());
+    const FunctionInfoBase* info = index ? &functions[*index] : nullptr;
     if (info == nullptr || info->handler_callback == nullptr) {
         return ReportUnimplementedFunction(ctx, info);
     }
@@ -94,18 +104,12 @@ void ServiceFrameworkBase::InvokeRequest(HLERequestContext& ctx) {
     handler_invoker(this, info->handler_callback, ctx);
 }
 
-void ServiceFrameworkBase::InvokeRequestTipc(HLERequestContext& ctx) {
-    boost::container::flat_map<u32, FunctionInfoBase>::iterator itr;
-
-    itr = handlers_tipc.find(ctx.GetCommand());
-
-    const FunctionInfoBase* info = itr == handlers_tipc.end() ? nullptr : &itr->second;
-    if (info == nullptr || info->handler_callback == nullptr) {
-        return ReportUnimplementedFunction(ctx, info);
-    }
+void ServiceFrameworkBase::InvokeRequest(HLERequestContext& ctx) {
+    InvokeHandler(ctx, handlers, handler_table);
+}
 
-    LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
-    handler_invoker(this, info->handler_callback, ctx);
+void ServiceFrameworkBase::InvokeRequestTipc(HLERequestContext& ctx) {
+    InvokeHandler(ctx, handlers_tipc, handler_table_tipc);
 }
 
 Result ServiceFrameworkBase::HandleSyncRequest(Kernel::KServerSession& session,
@@ -6,8 +6,9 @@
 #include <cstddef>
 #include <mutex>
 #include <string>
-#include <boost/container/flat_map.hpp>
+#include <vector>
 #include "common/common_types.h"
+#include "core/hle/service/command_table.h"
 #include "core/hle/service/hle_ipc.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -101,8 +102,13 @@ private:
                                   u32 max_sessions_, InvokerFn* handler_invoker_);
     ~ServiceFrameworkBase() override;
 
+    static void RegisterHandlersImpl(std::vector<FunctionInfoBase>& out_handlers,
+                                     CommandTable& out_table, const FunctionInfoBase* functions,
+                                     std::size_t n);
     void RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n);
     void RegisterHandlersBaseTipc(const FunctionInfoBase* functions, std::size_t n);
+    void InvokeHandler(HLERequestContext& ctx, const std::vector<FunctionInfoBase>& functions,
+                       const CommandTable& table);
     void ReportUnimplementedFunction(HLERequestContext& ctx, const FunctionInfoBase* info);
 
     /// Maximum number of concurrent sessions that this service can handle.
@@ -114,8 +120,10 @@ private:
 
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
-    boost::container::flat_map<u32, FunctionInfoBase> handlers;
-    boost::container::flat_map<u32, FunctionInfoBase> handlers_tipc;
+    std::vector<FunctionInfoBase> handlers;
+    std::vector<FunctionInfoBase> handlers_tipc;
+    CommandTable handler_table;
+    CommandTable handler_table_tipc;
 
     /// Used to gain exclusive access to the service members, e.g. from CoreTiming thread.
     std::mutex lock_service;
@@ -3,6 +3,8 @@
 
 #include "core/hle/service/services.h"
 
+#include "common/settings.h"
+
 #include "core/hle/service/acc/acc.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/aoc/addon_content_manager.h"
@@ -53,6 +55,7 @@
 #include "core/hle/service/psc/psc.h"
 #include "core/hle/service/ptm/ptm.h"
 #include "core/hle/service/ro/ro.h"
+#include "core/hle/service/server_executor.h"
 #include "core/hle/service/service.h"
 #include "core/hle/service/set/settings.h"
 #include "core/hle/service/sm/sm.h"
@@ -70,14 +73,28 @@ Services::Services(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system
 
     system.GetFileSystemController().CreateFactories(*system.GetFilesystem(), false);
 
+    // Host servers either get a thread each, or share the workers of an executor
+    if (Settings::values.use_service_executor.GetValue()) {
+        executor = std::make_unique<ServerExecutor>(system);
+    }
+    const auto run_on_host_core_process = [&](std::string&& name, std::function<void()>&& func) {
+        if (executor) {
+            executor->Post(std::move(func));
+        } else {
+            kernel.RunOnHostCoreProcess(std::move(name), std::move(func)).detach();
+        }
+    };
+
     // clang-format off
-    kernel.RunOnHostCoreProcess("audio",      [&] { Audio::LoopProcess(system); }).detach();
-    kernel.RunOnHostCoreProcess("FS",         [&] { FileSystem::LoopProcess(system); }).detach();
-    kernel.RunOnHostCoreProcess("jit",        [&] { JIT::LoopProcess(system); }).detach();
-    kernel.RunOnHostCoreProcess("ldn",        [&] { LDN::LoopProcess(system); }).detach();
-    kernel.RunOnHostCoreProcess("Loader",     [&] { LDR::LoopProcess(system); }).detach();
-    kernel.RunOnHostCoreProcess("nvservices", [&] { Nvidia::LoopProcess(system); }).detach();
+    run_on_host_core_process("audio",      [&] { Audio::LoopProcess(system); });
+    run_on_host_core_process("FS",         [&] { FileSystem::LoopProcess(system); });
+    run_on_host_core_process("jit",        [&] { JIT::LoopProcess(system); });
+    run_on_host_core_process("ldn",        [&] { LDN::LoopProcess(system); });
+    run_on_host_core_process("Loader",     [&] { LDR::LoopProcess(system); });
+    run_on_host_core_process("nvservices", [&] { Nvidia::LoopProcess(system); });
+    // bsdsocket blocks on host sockets for as long as the guest asks, it would starve the executor
     kernel.RunOnHostCoreProcess("bsdsocket",  [&] { Sockets::LoopProcess(system); }).detach();
+    // vi has to stay on its thread, it reacts to the stop token after its server is started
     kernel.RunOnHostCoreProcess("vi",         [&, token] { VI::LoopProcess(system, token); }).detach();
 
     kernel.RunOnGuestCoreProcess("sm",         [&] { SM::LoopProcess(system); });
@@ -3,11 +3,15 @@
 
 #pragma once
 
+#include <memory>
+
 #include "common/polyfill_thread.h"
 #include "core/hle/service/sm/sm.h"
 
 namespace Service {
 
+class ServerExecutor;
+
 /**
  * The purpose of this class is to own any objects that need to be shared across the other service
  * implementations. Will be torn down when the global system instance is shutdown.
@@ -17,6 +21,9 @@ public:
     explicit Services(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system,
                       std::stop_token token);
     ~Services();
+
+private:
+    std::unique_ptr<ServerExecutor> executor;
 };
 
 } // namespace Service
@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <mutex>
 #include <span>
@@ -38,6 +40,26 @@ bool AddressSpaceContains(const Common::PageTable& table, const Common::ProcessA
     return addr + size >= addr && addr + size <= max_addr;
 }
 
+/// Recent translations of the pages without a host pointer in the page table, debug and
+/// rasterizer cached pages, so repeated accesses to them skip the backing address lookup.
+struct SoftwareTlb {
+    static constexpr std::size_t NUM_ENTRIES = 64;
+
+    struct Entry {
+        u64 page{~0ULL};
+        u8* pointer{};
+    };
+
+    const void* owner{};
+    u64 generation{};
+    std::array<Entry, NUM_ENTRIES> entries{};
+};
+
+thread_local SoftwareTlb software_tlb;
+
+// Shared by every instance, so a new instance never matches the translations of an old one
+std::atomic<u64> software_tlb_generation{};
+
 } // namespace
 
 // Implementation class used to keep the specifics of the memory subsystem hidden
@@ -48,6 +70,7 @@ struct Memory::Impl {
 
     void SetCurrentPageTable(Kernel::KProcess& process) {
         current_page_table = &process.GetPageTable().GetImpl();
+        InvalidateSoftwareTlb();
 
         if (process.IsApplication() && Settings::IsFastmemEnabled()) {
             current_page_table->fastmem_arena = system.DeviceMemory().buffer.VirtualBasePointer();
@@ -72,6 +95,7 @@ struct Memory::Impl {
                    GetInteger(target));
         MapPages(page_table, base / SUYU_PAGESIZE, size / SUYU_PAGESIZE, target,
                  Common::PageType::Memory);
+        InvalidateSoftwareTlb();
 
         if (current_page_table->fastmem_arena) {
             buffer->Map(GetInteger(base), GetInteger(target) - DramMemoryMap::Base, size, perms,
@@ -85,6 +109,7 @@ struct Memory::Impl {
         ASSERT_MSG((base & SUYU_PAGEMASK) == 0, "non-page aligned base: {:016X}", GetInteger(base));
         MapPages(page_table, base / SUYU_PAGESIZE, size / SUYU_PAGESIZE, 0,
                  Common::PageType::Unmapped);
+        InvalidateSoftwareTlb();
 
         if (current_page_table->fastmem_arena) {
             buffer->Unmap(GetInteger(base), size, separate_heap);
@@ -96,6 +121,8 @@ struct Memory::Impl {
         ASSERT_MSG((size & SUYU_PAGEMASK) == 0, "non-page aligned size: {:016X}", size);
         ASSERT_MSG((vaddr & SUYU_PAGEMASK) == 0, "non-page aligned base: {:016X}", vaddr);
 
+        InvalidateSoftwareTlb();
+
         if (!current_page_table->fastmem_arena) {
             return;
         }
@@ -147,6 +174,39 @@ struct Memory::Impl {
         return system.DeviceMemory().GetPointer<u8>(paddr + vaddr);
     }
 
+    /// Translates an address of a debug or rasterizer cached page through the software TLB.
+    [[nodiscard]] u8* GetPointerFromBackingMemory(u64 vaddr) const {
+        SoftwareTlb& tlb = software_tlb;
+        const u64 generation = software_tlb_generation.load(std::memory_order_acquire);
+        if (tlb.owner != this || tlb.generation != generation) [[unlikely]] {
+            tlb.entries.fill({});
+            tlb.owner = this;
+            tlb.generation = generation;
+        }
+
+        const u64 page = vaddr >> SUYU_PAGEBITS;
+        const u64 page_offset = vaddr & SUYU_PAGEMASK;
+        SoftwareTlb::Entry& entry = tlb.entries[page % SoftwareTlb::NUM_ENTRIES];
+        if (entry.page == page) [[likely]] {
+            return entry.pointer + page_offset;
+        }
+
+        u8* const pointer = GetPointerFromDebugMemory(vaddr - page_offset);
+        if (pointer == nullptr) {
+            return nullptr;
+        }
+        entry = {
+            .page = page,
+            .pointer = pointer,
+        };
+        return pointer + page_offset;
+    }
+
+    /// Drops the translations cached by every thread, called when the mappings change.
+    void InvalidateSoftwareTlb() {
+        software_tlb_generation.fetch_add(1, std::memory_order_release);
+    }
+
     u8 Read8(const Common::ProcessAddress addr) {
         return Read<u8>(addr);
     }
@@ -257,11 +317,12 @@ struct Memory::Impl {
         }
 
         while (remaining_size) {
-            const std::size_t copy_amount =
+            std::size_t copy_amount =
                 std::min(static_cast<std::size_t>(SUYU_PAGESIZE) - page_offset, remaining_size);
             const auto current_vaddr =
                 static_cast<u64>((page_index << SUYU_PAGEBITS) + page_offset);
 
+            const uintptr_t raw_pointer = page_table.pointers[page_index].Raw();
             const auto [pointer, type] = page_table.pointers[page_index].PointerType();
             switch (type) {
             case Common::PageType::Unmapped: {
@@ -272,16 +333,25 @@ struct Memory::Impl {
             case Common::PageType::Memory: {
                 u8* mem_ptr =
                     reinterpret_cast<u8*>(pointer + page_offset + (page_index << SUYU_PAGEBITS));
+
+                // Pages contiguous in host memory store the same pointer, handle the whole run
+                // of them at once.
+                while (copy_amount < remaining_size &&
+                       page_table.pointers[page_index + 1].Raw() == raw_pointer) {
+                    copy_amount += std::min(static_cast<std::size_t>(SUYU_PAGESIZE),
+                                            remaining_size - copy_amount);
+                    page_index++;
+                }
                 on_memory(copy_amount, mem_ptr);
                 break;
             }
             case Common::PageType::DebugMemory: {
-                u8* const mem_ptr{GetPointerFromDebugMemory(current_vaddr)};
+                u8* const mem_ptr{GetPointerFromBackingMemory(current_vaddr)};
                 on_memory(copy_amount, mem_ptr);
                 break;
             }
             case Common::PageType::RasterizerCachedMemory: {
-                u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
+                u8* const host_ptr{GetPointerFromBackingMemory(current_vaddr)};
                 on_rasterizer(current_vaddr, copy_amount, host_ptr);
                 break;
             }
@@ -410,7 +480,7 @@ struct Memory::Impl {
     bool CopyBlock(Common::ProcessAddress dest_addr, Common::ProcessAddress src_addr,
                    const std::size_t size) {
         return WalkBlock(
-            dest_addr, size,
+            src_addr, size,
             [&](const std::size_t copy_amount, const Common::ProcessAddress current_vaddr) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped CopyBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
@@ -694,9 +764,9 @@ struct Memory::Impl {
             ASSERT_MSG(false, "Mapped memory page without a pointer @ 0x{:016X}", vaddr);
             return nullptr;
         case Common::PageType::DebugMemory:
-            return GetPointerFromDebugMemory(vaddr);
+            return GetPointerFromBackingMemory(vaddr);
         case Common::PageType::RasterizerCachedMemory: {
-            u8* const host_ptr{GetPointerFromRasterizerCachedMemory(vaddr)};
+            u8* const host_ptr{GetPointerFromBackingMemory(vaddr)};
             on_rasterizer();
             return host_ptr;
         }
@@ -1068,6 +1138,11 @@ Result Memory::FlushDataCache(Common::ProcessAddress dest_addr, const std::size_
     return impl->FlushDataCache(dest_addr, size);
 }
 
+void Memory::InvalidateRegion(Common::ProcessAddress dest_addr, const std::size_t size) {
+    // Same as a CPU cache store, the GPU invalidates what the CPU wrote
+    impl->StoreDataCache(dest_addr, size);
+}
+
 void Memory::RasterizerMarkRegionCached(Common::ProcessAddress vaddr, u64 size, bool cached) {
     impl->RasterizerMarkRegionCached(GetInteger(vaddr), size, cached);
 }
@@ -467,6 +467,15 @@ public:
      */
     Result FlushDataCache(Common::ProcessAddress dest_addr, std::size_t size);
 
+    /**
+     * Notifies the GPU that a range of bytes was written through a host pointer, so cached copies
+     * of it are invalidated.
+     *
+     * @param dest_addr The destination virtual address of the written range.
+     * @param size      The size of the written range, in bytes.
+     */
+    void InvalidateRegion(Common::ProcessAddress dest_addr, std::size_t size);
+
     /**
      * Marks each page within the specified address range as cached or uncached.
      *
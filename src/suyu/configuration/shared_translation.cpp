@@ -143,6 +143,10 @@ std::unique_ptr<TranslationMap> InitializeTranslations(QWidget* parent) {
            tr("Allows saving shaders to storage for faster loading on following game "
               "boots.\nDisabling "
               "it is only intended for debugging."));
+    INSERT(Settings, use_disk_texture_cache, tr("Use disk decoded texture cache"),
+           tr("Saves textures decoded on the CPU (ASTC and BCn) to storage, so they don't have "
+              "to be decoded again on following game boots.\n"
+              "Uses additional disk space."));
     INSERT(
         Settings, use_asynchronous_gpu_emulation, tr("Use asynchronous GPU emulation"),
         tr("Uses an extra CPU thread for rendering.\nThis option should always remain enabled."));
@@ -162,13 +166,24 @@ std::unique_ptr<TranslationMap> InitializeTranslations(QWidget* parent) {
         Settings, astc_recompression, tr("ASTC Recompression Method:"),
         tr("Almost all desktop and laptop dedicated GPUs lack support for ASTC textures, forcing "
            "the emulator to decompress to an intermediate format any card supports, RGBA8.\n"
-           "This option recompresses RGBA8 to either the BC1 or BC3 format, saving VRAM but "
+           "This option recompresses RGBA8 to the BC1, BC3 or BC7 format, saving VRAM but "
            "negatively affecting image quality."));
+    INSERT(Settings, bc7_quality, tr("BC7 Encoding Quality:"),
+           tr("Controls how thoroughly textures recompressed to BC7 are encoded.\n"
+              "Higher quality settings reduce artifacts but take longer to encode."));
     INSERT(Settings, vram_usage_mode, tr("VRAM Usage Mode:"),
            tr("Selects whether the emulator should prefer to conserve memory or make maximum usage "
               "of available video memory for performance. Has no effect on integrated graphics. "
               "Aggressive mode may severely impact the performance of other applications such as "
               "recording software."));
+    INSERT(Settings, vram_budget, tr("Texture VRAM Budget (MiB):"),
+           tr("Limits how much video memory the texture cache keeps before evicting textures. "
+              "Set to 0 to derive the limit from the available video memory."));
+    INSERT(Settings, query_result_latency, tr("Query Result Latency:"),
+           tr("Lets the game read occlusion and streamout query results up to this many GPU "
+              "submissions late instead of waiting for the GPU to finish them.\n"
+              "Improves performance in games that test many objects for visibility, but may cause "
+              "objects to pop in late. Set to 0 to always wait for the results."));
     INSERT(
         Settings, vsync_mode, tr("VSync Mode:"),
         tr("FIFO (VSync) does not drop frames or exhibit tearing but is limited by the screen "
@@ -319,7 +334,14 @@ std::unique_ptr<ComboboxTranslationMap> ComboboxEnumeration(QWidget* parent) {
              PAIR(AstcRecompression, Uncompressed, tr("Uncompressed (Best quality)")),
              PAIR(AstcRecompression, Bc1, tr("BC1 (Low quality)")),
              PAIR(AstcRecompression, Bc3, tr("BC3 (Medium quality)")),
+             PAIR(AstcRecompression, Bc7, tr("BC7 (High quality)")),
          }});
+    translations->insert({Settings::EnumMetadata<Settings::Bc7Quality>::Index(),
+                          {
+                              PAIR(Bc7Quality, Fast, tr("Fast")),
+                              PAIR(Bc7Quality, Medium, tr("Medium")),
+                              PAIR(Bc7Quality, High, tr("High")),
+                          }});
     translations->insert({Settings::EnumMetadata<Settings::VramUsageMode>::Index(),
                           {
                               PAIR(VramUsageMode, Conservative, tr("Conservative")),
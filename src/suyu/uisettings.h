@@ -262,5 +262,6 @@ Q_DECLARE_METATYPE(Settings::AntiAliasing);
 Q_DECLARE_METATYPE(Settings::RendererBackend);
 Q_DECLARE_METATYPE(Settings::ShaderBackend);
 Q_DECLARE_METATYPE(Settings::AstcRecompression);
+Q_DECLARE_METATYPE(Settings::Bc7Quality);
 Q_DECLARE_METATYPE(Settings::AstcDecodeMode);
 Q_DECLARE_METATYPE(Settings::DarkModeState);
@@ -471,7 +471,8 @@ int main(int argc, char** argv) {
     system.GPU().Start();
     system.GetCpuManager().OnGpuReady();
 
-    if (Settings::values.use_disk_shader_cache.GetValue()) {
+    if (Settings::values.use_disk_shader_cache.GetValue() ||
+        Settings::values.use_disk_texture_cache.GetValue()) {
         system.Renderer().ReadRasterizer()->LoadDiskResources(
             system.GetApplicationProcessProgramID(), std::stop_token{},
             [](VideoCore::LoadCallbackStage, size_t value, size_t total) {});
@@ -3,13 +3,17 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <optional>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -40,6 +44,17 @@ struct ScopeInit final {
     Core::Timing::CoreTiming core_timing;
 };
 
+/// Advances single core timing to the given time in nanoseconds.
+void AdvanceSingleCoreTo(Core::Timing::CoreTiming& core_timing, u64& cpu_ticks, u64 ns) {
+    // CPU ticks run at 1020 MHz, round up so the target time is reached
+    const u64 target_ticks = ns / 50 * 51 + 51;
+    if (target_ticks > cpu_ticks) {
+        core_timing.AddTicks(target_ticks - cpu_ticks);
+        cpu_ticks = target_ticks;
+    }
+    core_timing.Advance();
+}
+
 u64 TestTimerSpeed(Core::Timing::CoreTiming& core_timing) {
     const u64 start = core_timing.GetGlobalTimeNs().count();
     volatile u64 placebo = 0;
@@ -139,3 +154,110 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[WheelOrder]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    constexpr size_t NUM_EVENTS = 4096;
+    std::mt19937_64 rng{0x71e};
+    std::vector<std::pair<s64, size_t>> fired;
+    std::vector<std::pair<s64, size_t>> expected;
+    std::vector<std::shared_ptr<Core::Timing::EventType>> events;
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+        events.push_back(Core::Timing::CreateEvent(
+            "wheel", [i, &fired](s64 time, std::chrono::nanoseconds) {
+                fired.emplace_back(time, i);
+                return std::optional<std::chrono::nanoseconds>{};
+            }));
+    }
+    // Times cover every level of the wheel and the overflow list, some of them are repeated to
+    // check that events due at the same time run in scheduling order
+    constexpr std::array<s64, 4> ranges{2'000, 1'000'000, 10'000'000'000, 10'000'000'000'000};
+    std::vector<s64> times(NUM_EVENTS);
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+        times[i] = i > 0 && rng() % 4 == 0 ? times[rng() % i]
+                                           : static_cast<s64>(rng() % ranges[rng() % 4]);
+        core_timing.ScheduleEvent(std::chrono::nanoseconds{times[i]}, events[i], true);
+    }
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+        if (i % 5 == 0) {
+            core_timing.UnscheduleEvent(events[i], Core::Timing::UnscheduleEventType::NoWait);
+        } else {
+            expected.emplace_back(times[i], i);
+        }
+    }
+    std::ranges::stable_sort(expected, {}, &std::pair<s64, size_t>::first);
+
+    u64 cpu_ticks = 0;
+    s64 now = 0;
+    while (fired.size() < expected.size() && now <= ranges.back()) {
+        now += static_cast<s64>(rng() % 2 == 0 ? rng() % 5'000 : rng() % 50'000'000'000);
+        AdvanceSingleCoreTo(core_timing, cpu_ticks, static_cast<u64>(now));
+        for (const auto& [time, index] : fired) {
+            REQUIRE(time <= core_timing.GetGlobalTimeNs().count());
+        }
+    }
+    REQUIRE(fired == expected);
+}
+
+TEST_CASE("CoreTiming[Benchmark]", "[core][.benchmark]") {
+    constexpr size_t NUM_EVENTS = 1 << 16;
+    constexpr size_t NUM_THREADS = 4;
+
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    std::vector<std::shared_ptr<Core::Timing::EventType>> events;
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+        events.push_back(Core::Timing::CreateEvent("benchmark", [](s64, std::chrono::nanoseconds) {
+            return std::optional<std::chrono::nanoseconds>{};
+        }));
+    }
+    std::mt19937_64 rng{0xbe4c};
+    std::vector<std::chrono::nanoseconds> delays(NUM_EVENTS);
+    for (auto& delay : delays) {
+        delay = std::chrono::nanoseconds{static_cast<s64>(rng() % 100'000'000)};
+    }
+
+    const auto report = [](const char* name, size_t count, auto start) {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        printf("CoreTiming %s: %.0f ops/s\n", name, static_cast<double>(count) / elapsed.count());
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+        core_timing.ScheduleEvent(delays[i], events[i]);
+    }
+    report("schedule", NUM_EVENTS, start);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+        core_timing.UnscheduleEvent(events[i], Core::Timing::UnscheduleEventType::NoWait);
+    }
+    report("unschedule", NUM_EVENTS, start);
+
+    // Guest cores schedule concurrently in multicore mode
+    start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (size_t i = thread; i < NUM_EVENTS; i += NUM_THREADS) {
+                    core_timing.ScheduleEvent(delays[i], events[i]);
+                }
+            });
+        }
+    }
+    report("concurrent schedule", NUM_EVENTS, start);
+
+    u64 cpu_ticks = 0;
+    start = std::chrono::steady_clock::now();
+    for (u64 ns = 0; ns <= 100'000'000; ns += 10'000) {
+        AdvanceSingleCoreTo(core_timing, cpu_ticks, ns);
+    }
+    report("advance", NUM_EVENTS, start);
+    REQUIRE(!core_timing.Advance());
+}
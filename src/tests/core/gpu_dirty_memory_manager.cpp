@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/gpu_dirty_memory_manager.h"
+
+namespace {
+using Range = std::pair<PAddr, size_t>;
+
+std::vector<Range> GatherAll(std::span<Core::GPUDirtyMemoryManager> managers) {
+    std::vector<Range> ranges;
+    std::function<void(PAddr, size_t)> callback = [&](PAddr address, size_t size) {
+        ranges.emplace_back(address, size);
+    };
+    Core::GPUDirtyMemoryManager::Gather(managers, callback);
+    return ranges;
+}
+} // Anonymous namespace
+
+TEST_CASE("GPUDirtyMemoryManager[Collect]", "[core]") {
+    std::array<Core::GPUDirtyMemoryManager, 1> managers;
+    managers[0].Collect(0x10000, 4);
+    managers[0].Collect(0x10040, 0x40);
+    managers[0].Collect(0x20000, 0x80);
+
+    const auto ranges = GatherAll(managers);
+    REQUIRE(ranges == std::vector<Range>{{0x10000, 0x80}, {0x20000, 0x80}});
+    REQUIRE(GatherAll(managers).empty());
+}
+
+TEST_CASE("GPUDirtyMemoryManager[Merge]", "[core]") {
+    std::array<Core::GPUDirtyMemoryManager, 4> managers;
+
+    // Every core writes the same range, and ranges continue across pages
+    for (auto& manager : managers) {
+        manager.Collect(0x1000, 0x40);
+    }
+    managers[0].Collect(0x7C0, 0x40);
+    managers[1].Collect(0x800, 0x800);
+    managers[2].Collect(0x4000, 0x40);
+
+    const auto ranges = GatherAll(managers);
+    REQUIRE(ranges == std::vector<Range>{{0x7C0, 0x880}, {0x4000, 0x40}});
+}
+
+TEST_CASE("GPUDirtyMemoryManager[Overflow]", "[core]") {
+    std::array<Core::GPUDirtyMemoryManager, 1> managers;
+
+    // More pages than the staging ring holds before the GPU gathers
+    constexpr size_t NUM_PAGES = 4096;
+    for (size_t i = 0; i < NUM_PAGES; ++i) {
+        managers[0].Collect(i * 0x1000, 0x40);
+    }
+
+    const auto ranges = GatherAll(managers);
+    REQUIRE(ranges.size() == NUM_PAGES);
+    for (size_t i = 0; i < NUM_PAGES; ++i) {
+        REQUIRE(ranges[i] == Range{i * 0x1000, 0x40});
+    }
+}
+
+TEST_CASE("GPUDirtyMemoryManager[SharedProducers]", "[core]") {
+    std::array<Core::GPUDirtyMemoryManager, 1> managers;
+
+    // Threads that aren't guest cores all collect into the same manager
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_PAGES = 512;
+    {
+        std::vector<std::jthread> threads;
+        for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+            threads.emplace_back([&, thread] {
+                for (size_t i = 0; i < NUM_PAGES; ++i) {
+                    managers[0].Collect((thread * NUM_PAGES + i) * 0x1000, 0x40);
+                }
+            });
+        }
+    }
+
+    const auto ranges = GatherAll(managers);
+    REQUIRE(ranges.size() == NUM_THREADS * NUM_PAGES);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        REQUIRE(ranges[i] == Range{i * 0x1000, 0x40});
+    }
+}
+
+TEST_CASE("GPUDirtyMemoryManager[Benchmark]", "[core][.benchmark]") {
+    constexpr size_t NUM_CORES = 4;
+    constexpr size_t NUM_WRITES = 1 << 22;
+
+    std::array<Core::GPUDirtyMemoryManager, NUM_CORES> managers;
+    std::atomic<bool> done{};
+    size_t num_gathered = 0;
+    std::function<void(PAddr, size_t)> callback = [&](PAddr, size_t size) {
+        num_gathered += size;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        // The GPU thread gathers while the cores write
+        std::jthread gpu_thread([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                Core::GPUDirtyMemoryManager::Gather(managers, callback);
+            }
+        });
+        std::vector<std::jthread> cores;
+        for (size_t core = 0; core < NUM_CORES; ++core) {
+            cores.emplace_back([&, core] {
+                for (size_t i = 0; i < NUM_WRITES; ++i) {
+                    const PAddr address = (core << 24) + ((i * 0x40) & 0xFFFFFF);
+                    managers[core].Collect(address, 0x40);
+                }
+            });
+        }
+        cores.clear();
+        done = true;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    Core::GPUDirtyMemoryManager::Gather(managers, callback);
+
+    REQUIRE(num_gathered > 0);
+    printf("GPUDirtyMemoryManager collect: %.0f writes/s\n",
+           static_cast<double>(NUM_CORES * NUM_WRITES) / elapsed.count());
+}
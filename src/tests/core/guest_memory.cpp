@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/scratch_buffer.h"
+#include "core/guest_memory.h"
+
+namespace {
+constexpr u64 PAGE_SIZE = 0x1000;
+constexpr size_t NUM_PAGES = 4;
+
+using Range = std::pair<u64, size_t>;
+
+/// Guest memory where every page is a separate host allocation, so only ranges within a page are
+/// contiguous in host memory.
+class FakeMemory {
+public:
+    static constexpr bool HAS_FLUSH_INVALIDATION = false;
+
+    FakeMemory() {
+        for (auto& page : pages) {
+            page = std::make_unique<std::array<u8, PAGE_SIZE>>();
+            page->fill(0);
+        }
+    }
+
+    u8* GetSpan(u64 address, size_t size) {
+        if (address / PAGE_SIZE != (address + size - 1) / PAGE_SIZE) {
+            return nullptr;
+        }
+        return Pointer(address);
+    }
+
+    void WriteBlock(u64 address, const void* data, size_t size) {
+        writes.emplace_back(address, size);
+        const u8* source = static_cast<const u8*>(data);
+        for (size_t offset = 0; offset < size; ++offset) {
+            *Pointer(address + offset) = source[offset];
+        }
+    }
+
+    void InvalidateRegion(u64 address, size_t size) {
+        invalidations.emplace_back(address, size);
+    }
+
+    u8 Read(u64 address) {
+        return *Pointer(address);
+    }
+
+    std::vector<Range> writes;
+    std::vector<Range> invalidations;
+
+private:
+    u8* Pointer(u64 address) {
+        return pages[address / PAGE_SIZE]->data() + address % PAGE_SIZE;
+    }
+
+    std::array<std::unique_ptr<std::array<u8, PAGE_SIZE>>, NUM_PAGES> pages;
+};
+
+using WriteMemory =
+    Core::Memory::GuestMemoryScoped<FakeMemory, u8, Core::Memory::GuestMemoryFlags::SafeWrite>;
+} // Anonymous namespace
+
+TEST_CASE("GuestMemory[WriteInPlace]", "[core]") {
+    FakeMemory memory;
+    {
+        WriteMemory view(memory, PAGE_SIZE + 0x10, 0x20);
+        std::fill(view.begin(), view.end(), u8{0xaa});
+        // Writes go straight to guest memory
+        REQUIRE(memory.Read(PAGE_SIZE + 0x10) == 0xaa);
+        REQUIRE(memory.Read(PAGE_SIZE + 0x2f) == 0xaa);
+    }
+    REQUIRE(memory.writes.empty());
+    REQUIRE(memory.invalidations == std::vector<Range>{{PAGE_SIZE + 0x10, 0x20}});
+}
+
+TEST_CASE("GuestMemory[WriteSplitPage]", "[core]") {
+    FakeMemory memory;
+    Common::ScratchBuffer<u8> scratch;
+    const u64 address = PAGE_SIZE * 2 - 0x8;
+    {
+        WriteMemory view(memory, address, 0x10, &scratch);
+        REQUIRE(view.data() == scratch.data());
+        std::fill(view.begin(), view.end(), u8{0x55});
+        // Nothing reaches guest memory until the view is destroyed
+        REQUIRE(memory.Read(address) == 0);
+        REQUIRE(memory.Read(address + 0xf) == 0);
+    }
+    REQUIRE(memory.writes == std::vector<Range>{{address, 0x10}});
+    REQUIRE(memory.invalidations.empty());
+    for (u64 offset = 0; offset < 0x10; ++offset) {
+        REQUIRE(memory.Read(address + offset) == 0x55);
+    }
+}
+
+TEST_CASE("GuestMemory[WriteAliased]", "[core]") {
+    FakeMemory memory;
+    Common::ScratchBuffer<u8> first_scratch;
+    Common::ScratchBuffer<u8> second_scratch;
+    {
+        // Overlapping views are redirected to copies, as output buffer views of a request are
+        WriteMemory first(memory, 0x100, 0x20, &first_scratch);
+        WriteMemory second(memory, 0x110, 0x20, &second_scratch);
+        first.SetDataCopy(&first_scratch);
+        second.SetDataCopy(&second_scratch);
+
+        std::fill(first.begin(), first.end(), u8{0x11});
+        std::fill(second.begin(), second.end(), u8{0x22});
+        // Neither view observes the writes of the other
+        REQUIRE(std::ranges::all_of(first, [](u8 value) { return value == 0x11; }));
+        REQUIRE(std::ranges::all_of(second, [](u8 value) { return value == 0x22; }));
+        REQUIRE(memory.Read(0x110) == 0);
+    }
+    // Views are written back in destruction order, so the first one wins on the overlap
+    REQUIRE(memory.writes == std::vector<Range>{{0x110, 0x20}, {0x100, 0x20}});
+    REQUIRE(memory.invalidations.empty());
+    REQUIRE(memory.Read(0x100) == 0x11);
+    REQUIRE(memory.Read(0x11f) == 0x11);
+    REQUIRE(memory.Read(0x120) == 0x22);
+    REQUIRE(memory.Read(0x12f) == 0x22);
+}
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "core/hardware_properties.h"
+#include "core/hle/kernel/k_affinity_mask.h"
+#include "core/hle/kernel/k_priority_queue.h"
+
+namespace {
+constexpr size_t NUM_CORES = Core::Hardware::NUM_CPU_CORES;
+
+// Minimal stand-in for KThread, with only what the priority queue uses
+class MockThread {
+public:
+    class QueueEntry {
+    public:
+        constexpr void Initialize() {
+            m_prev = nullptr;
+            m_next = nullptr;
+        }
+        constexpr MockThread* GetPrev() const {
+            return m_prev;
+        }
+        constexpr MockThread* GetNext() const {
+            return m_next;
+        }
+        constexpr void SetPrev(MockThread* thread) {
+            m_prev = thread;
+        }
+        constexpr void SetNext(MockThread* thread) {
+            m_next = thread;
+        }
+
+    private:
+        MockThread* m_prev{};
+        MockThread* m_next{};
+    };
+
+    MockThread(s32 priority, s32 core, u64 affinity) : m_priority{priority}, m_core{core} {
+        m_affinity.SetAffinityMask(affinity);
+    }
+
+    QueueEntry& GetPriorityQueueEntry(s32 core) {
+        return m_entries[core];
+    }
+    const QueueEntry& GetPriorityQueueEntry(s32 core) const {
+        return m_entries[core];
+    }
+    const Kernel::KAffinityMask& GetAffinityMask() const {
+        return m_affinity;
+    }
+    s32 GetActiveCore() const {
+        return m_core;
+    }
+    void SetActiveCore(s32 core) {
+        m_core = core;
+    }
+    s32 GetPriority() const {
+        return m_priority;
+    }
+    bool IsDummyThread() const {
+        return false;
+    }
+
+private:
+    std::array<QueueEntry, NUM_CORES> m_entries{};
+    Kernel::KAffinityMask m_affinity{};
+    s32 m_priority;
+    s32 m_core;
+};
+
+using PriorityQueue = Kernel::KPriorityQueue<MockThread, NUM_CORES, 63, 0>;
+} // Anonymous namespace
+
+TEST_CASE("KPriorityQueue[Order]", "[core]") {
+    std::vector<MockThread> threads{{44, 0, 0b0001}, {28, 0, 0b0011}, {44, 0, 0b0001},
+                                    {59, 1, 0b0011}, {16, 1, 0b0010}};
+    auto queue = std::make_unique<PriorityQueue>();
+    for (auto& thread : threads) {
+        queue->PushBack(&thread);
+    }
+
+    // Scheduled threads of core 0 come in priority order, FIFO within a priority
+    REQUIRE(queue->GetScheduledFront(0) == &threads[1]);
+    REQUIRE(queue->GetScheduledNext(0, &threads[1]) == &threads[0]);
+    REQUIRE(queue->GetScheduledNext(0, &threads[0]) == &threads[2]);
+    REQUIRE(queue->GetScheduledNext(0, &threads[2]) == nullptr);
+    REQUIRE(queue->GetScheduledFront(0, 44) == &threads[0]);
+    REQUIRE(queue->GetScheduledFront(0, 45) == nullptr);
+
+    // Threads that may run on other cores are suggested to them
+    REQUIRE(queue->GetScheduledFront(1) == &threads[4]);
+    REQUIRE(queue->GetSuggestedFront(1) == &threads[1]);
+    REQUIRE(queue->GetSuggestedFront(0) == &threads[3]);
+    REQUIRE(queue->GetSuggestedNext(1, &threads[1]) == nullptr);
+    REQUIRE(queue->GetSuggestedFront(2) == nullptr);
+
+    // Migrating a thread moves it from the suggested to the scheduled queue
+    threads[1].SetActiveCore(1);
+    queue->ChangeCore(0, &threads[1]);
+    REQUIRE(queue->GetScheduledFront(0) == &threads[0]);
+    REQUIRE(queue->GetSuggestedFront(0) == &threads[1]);
+    REQUIRE(queue->GetScheduledNext(1, &threads[4]) == &threads[1]);
+
+    queue->Remove(&threads[4]);
+    REQUIRE(queue->GetScheduledFront(1) == &threads[1]);
+}
+
+TEST_CASE("KPriorityQueue[Benchmark]", "[core][.benchmark]") {
+    constexpr size_t NUM_THREADS = 256;
+    constexpr size_t NUM_ITERATIONS = 1 << 22;
+
+    // Games use a few high priority threads and a large pool of workers, pinned or free
+    std::mt19937 rng{0x5c4};
+    std::vector<MockThread> threads;
+    threads.reserve(NUM_THREADS);
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        const s32 priority = static_cast<s32>(i < 16 ? rng() % 32 : 32 + rng() % 28);
+        const s32 core = static_cast<s32>(rng() % NUM_CORES);
+        const u64 affinity = rng() % 2 ? (1ULL << NUM_CORES) - 1 : 1ULL << core;
+        threads.emplace_back(priority, core, affinity);
+    }
+
+    auto queue = std::make_unique<PriorityQueue>();
+    for (auto& thread : threads) {
+        queue->PushBack(&thread);
+    }
+
+    // Simulate reschedules: pick the top thread per core, look for migrations onto a core,
+    // then have a thread block and wake up again
+    size_t num_found = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        const s32 core = static_cast<s32>(i % NUM_CORES);
+        for (s32 c = 0; c < static_cast<s32>(NUM_CORES); ++c) {
+            num_found += queue->GetScheduledFront(c) != nullptr;
+        }
+        for (auto* suggested = queue->GetSuggestedFront(core); suggested != nullptr;
+             suggested = queue->GetSuggestedNext(core, suggested)) {
+            if (suggested->GetPriority() >= 32) {
+                break;
+            }
+            ++num_found;
+        }
+
+        MockThread& thread = threads[rng() % NUM_THREADS];
+        queue->Remove(&thread);
+        queue->PushBack(&thread);
+        if (MockThread* top = queue->GetScheduledFront(core)) {
+            queue->MoveToScheduledBack(top);
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(num_found > 0);
+    printf("KPriorityQueue reschedule: %.0f updates/s\n",
+           static_cast<double>(NUM_ITERATIONS) / elapsed.count());
+}
@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/hle/kernel/k_dynamic_page_manager.h"
+#include "core/hle/kernel/k_dynamic_slab_heap.h"
+#include "core/hle/kernel/k_slab_heap.h"
+
+namespace {
+struct Object {
+    u64 owner;
+    u64 serial;
+    std::array<u64, 6> padding;
+};
+static_assert(sizeof(Object) == 64);
+
+using Kernel::impl::KSlabHeapImpl;
+
+// Not a multiple of the magazine size, so some objects stay cached in a magazine
+constexpr size_t NUM_OBJECTS = 3 * KSlabHeapImpl::MagazineSize + 5;
+constexpr size_t NUM_THREADS = KSlabHeapImpl::NumMagazines;
+
+class SlabHeap {
+public:
+    SlabHeap() {
+        heap.Initialize(storage.data(), sizeof(storage));
+    }
+
+    Kernel::KSlabHeap<Object> heap;
+
+private:
+    std::array<Object, NUM_OBJECTS> storage;
+};
+
+std::vector<Object*> AllocateAll(Kernel::KSlabHeap<Object>& heap) {
+    std::vector<Object*> objects;
+    while (Object* const object = heap.Allocate()) {
+        objects.push_back(object);
+    }
+    return objects;
+}
+
+/// Checks that every object of the heap is handed out exactly once.
+bool IsEveryObjectOnce(const Kernel::KSlabHeap<Object>& heap, const std::vector<Object*>& objects) {
+    std::set<size_t> indices;
+    for (const Object* const object : objects) {
+        indices.insert(heap.GetObjectIndex(object));
+    }
+    return objects.size() == NUM_OBJECTS && indices.size() == NUM_OBJECTS &&
+           *indices.rbegin() == NUM_OBJECTS - 1;
+}
+} // Anonymous namespace
+
+TEST_CASE("KSlabHeap[Exhaust]", "[core]") {
+    SlabHeap slab;
+    REQUIRE(slab.heap.GetSlabHeapSize() == NUM_OBJECTS);
+
+    std::vector<Object*> objects = AllocateAll(slab.heap);
+    REQUIRE(IsEveryObjectOnce(slab.heap, objects));
+    REQUIRE(slab.heap.Allocate() == nullptr);
+
+    for (Object* const object : objects) {
+        slab.heap.Free(object);
+    }
+    objects = AllocateAll(slab.heap);
+    REQUIRE(IsEveryObjectOnce(slab.heap, objects));
+}
+
+TEST_CASE("KSlabHeap[MagazinesAcrossThreads]", "[core]") {
+    SlabHeap slab;
+
+    // One thread refills its magazine from the shared list until the heap is empty
+    std::vector<Object*> allocated;
+    std::thread([&] { allocated = AllocateAll(slab.heap); }).join();
+    REQUIRE(IsEveryObjectOnce(slab.heap, allocated));
+
+    // Another one frees them, flushing full batches back to the shared list and keeping the rest
+    std::thread([&] {
+        for (Object* const object : allocated) {
+            slab.heap.Free(object);
+        }
+    }).join();
+
+    // A third one gets all of them back, the ones left in the other magazine included
+    std::vector<Object*> reallocated;
+    bool is_exhausted{};
+    std::thread([&] {
+        reallocated = AllocateAll(slab.heap);
+        is_exhausted = slab.heap.Allocate() == nullptr;
+    }).join();
+    REQUIRE(IsEveryObjectOnce(slab.heap, reallocated));
+    REQUIRE(is_exhausted);
+}
+
+TEST_CASE("KSlabHeap[Concurrent]", "[core]") {
+    constexpr size_t MAX_HELD = NUM_OBJECTS / NUM_THREADS;
+    constexpr size_t NUM_ITERATIONS = 20000;
+
+    SlabHeap slab;
+    std::array<std::atomic<bool>, NUM_OBJECTS> is_used{};
+    std::atomic<size_t> num_errors{};
+
+    // Catch2 assertions aren't thread safe, the workers only count what went wrong
+    std::vector<std::jthread> threads;
+    for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+        threads.emplace_back([&, thread] {
+            std::mt19937 rng{static_cast<u32>(thread)};
+            std::vector<Object*> held;
+            u64 serial = 0;
+            const auto free_one = [&] {
+                Object* const object = held.back();
+                held.pop_back();
+                if (object->owner != thread || object->serial != serial--) {
+                    ++num_errors;
+                }
+                is_used[slab.heap.GetObjectIndex(object)] = false;
+                slab.heap.Free(object);
+            };
+            for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+                if (held.size() == MAX_HELD || (!held.empty() && rng() % 2 == 0)) {
+                    free_one();
+                    continue;
+                }
+                // The other threads never hold more than their share, this can't fail
+                Object* const object = slab.heap.Allocate();
+                if (object == nullptr || is_used[slab.heap.GetObjectIndex(object)].exchange(true)) {
+                    ++num_errors;
+                    continue;
+                }
+                object->owner = thread;
+                object->serial = ++serial;
+                held.push_back(object);
+            }
+            while (!held.empty()) {
+                free_one();
+            }
+        });
+    }
+    threads.clear();
+    REQUIRE(num_errors == 0);
+
+    const std::vector<Object*> objects = AllocateAll(slab.heap);
+    REQUIRE(IsEveryObjectOnce(slab.heap, objects));
+}
+
+TEST_CASE("KDynamicSlabHeap[UsedAndPeak]", "[core]") {
+    constexpr size_t OBJECTS_PER_PAGE = Kernel::PageSize / sizeof(Object);
+
+    Kernel::KDynamicPageManager page_manager;
+    const Result result = page_manager.Initialize(Kernel::KVirtualAddress{0x10000000},
+                                                  16 * Kernel::PageSize, Kernel::PageSize);
+    REQUIRE(result.IsSuccess());
+    Kernel::KDynamicSlabHeap<Object> heap;
+    heap.Initialize(&page_manager, OBJECTS_PER_PAGE);
+    REQUIRE(heap.GetCount() == OBJECTS_PER_PAGE);
+    REQUIRE(heap.GetUsed() == 0);
+    REQUIRE(heap.GetPeak() == 0);
+
+    std::vector<Object*> objects;
+    for (size_t i = 0; i < OBJECTS_PER_PAGE; ++i) {
+        objects.push_back(heap.Allocate(nullptr));
+    }
+    REQUIRE(std::ranges::find(objects, nullptr) == objects.end());
+    REQUIRE(heap.Allocate(nullptr) == nullptr);
+    REQUIRE(heap.GetUsed() == OBJECTS_PER_PAGE);
+
+    // Growing takes a new page from the page manager
+    objects.push_back(heap.Allocate(&page_manager));
+    REQUIRE(objects.back() != nullptr);
+    REQUIRE(heap.GetCount() == 2 * OBJECTS_PER_PAGE);
+    REQUIRE(heap.GetUsed() == OBJECTS_PER_PAGE + 1);
+    REQUIRE(heap.GetPeak() == OBJECTS_PER_PAGE + 1);
+
+    // Freeing lowers the used count but not the peak
+    for (size_t i = 0; i < OBJECTS_PER_PAGE / 2; ++i) {
+        heap.Free(objects.back());
+        objects.pop_back();
+    }
+    REQUIRE(heap.GetUsed() == OBJECTS_PER_PAGE / 2 + 1);
+    REQUIRE(heap.GetPeak() == OBJECTS_PER_PAGE + 1);
+
+    // Objects freed on other threads stay in their magazines, they're still counted as free
+    std::vector<std::jthread> threads;
+    std::atomic<size_t> num_failures{};
+    for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < 1000; ++i) {
+                std::array<Object*, OBJECTS_PER_PAGE / (2 * NUM_THREADS)> held;
+                for (Object*& object : held) {
+                    object = heap.Allocate(nullptr);
+                    if (object == nullptr) {
+                        ++num_failures;
+                    }
+                }
+                for (Object* const object : held) {
+                    if (object != nullptr) {
+                        heap.Free(object);
+                    }
+                }
+            }
+        });
+    }
+    threads.clear();
+    REQUIRE(num_failures == 0);
+    REQUIRE(heap.GetUsed() == objects.size());
+    REQUIRE(heap.GetPeak() >= OBJECTS_PER_PAGE + 1);
+    REQUIRE(heap.GetPeak() <= heap.GetCount());
+
+    for (size_t i = objects.size(); i < heap.GetCount(); ++i) {
+        objects.push_back(heap.Allocate(nullptr));
+    }
+    REQUIRE(std::ranges::find(objects, nullptr) == objects.end());
+    REQUIRE(std::set<Object*>(objects.begin(), objects.end()).size() == heap.GetCount());
+    REQUIRE(heap.Allocate(nullptr) == nullptr);
+    REQUIRE(heap.GetUsed() == heap.GetCount());
+    REQUIRE(heap.GetPeak() == heap.GetCount());
+
+    for (Object* const object : objects) {
+        heap.Free(object);
+    }
+    REQUIRE(heap.GetUsed() == 0);
+    REQUIRE(heap.GetPeak() == heap.GetCount());
+    REQUIRE(heap.GetCount() == 2 * OBJECTS_PER_PAGE);
+}
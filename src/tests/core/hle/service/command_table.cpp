@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <boost/container/flat_map.hpp>
+
+#include "core/hle/service/command_table.h"
+
+namespace {
+// Mix of the small dense ids most interfaces use and the large ones of hid and am
+constexpr std::array<u32, 12> command_ids{0, 1, 2, 3, 10, 11, 66, 100, 1000, 2048, 10001, 50000};
+
+struct NoopService {
+    void Noop() {
+        ++count;
+    }
+    size_t count{};
+};
+using Handler = void (NoopService::*)();
+
+/// Dispatches num_requests requests through find, which maps a command id to its handler.
+template <typename Find>
+double BenchmarkDispatch(size_t num_requests, Find&& find) {
+    std::mt19937 rng{0x1bc};
+    std::vector<u32> requests(4096);
+    for (auto& request : requests) {
+        request = command_ids[rng() % command_ids.size()];
+    }
+
+    NoopService service;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_requests; ++i) {
+        (service.*find(requests[i % requests.size()]))();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(service.count == num_requests);
+    return static_cast<double>(num_requests) / elapsed.count();
+}
+} // Anonymous namespace
+
+TEST_CASE("CommandTable[Lookup]", "[core]") {
+    Service::CommandTable table;
+    for (u16 i = 0; i < command_ids.size(); ++i) {
+        table.Insert(command_ids[i], i);
+    }
+
+    for (u16 i = 0; i < command_ids.size(); ++i) {
+        REQUIRE(table.Find(command_ids[i]) == i);
+    }
+    REQUIRE(!table.Find(4));
+    REQUIRE(!table.Find(2047));
+    REQUIRE(!table.Find(2049));
+    REQUIRE(!table.Find(60000));
+}
+
+TEST_CASE("CommandTable[Duplicate]", "[core]") {
+    Service::CommandTable table;
+    table.Insert(5, 0);
+    table.Insert(5, 1);
+    table.Insert(20000, 2);
+    table.Insert(20000, 3);
+
+    REQUIRE(table.Find(5) == 0);
+    REQUIRE(table.Find(20000) == 2);
+}
+
+TEST_CASE("CommandTable[Benchmark]", "[core][.benchmark]") {
+    constexpr size_t NUM_REQUESTS = 1 << 24;
+
+    Service::CommandTable table;
+    std::vector<Handler> handlers;
+    boost::container::flat_map<u32, Handler> handler_map;
+    for (u16 i = 0; i < command_ids.size(); ++i) {
+        table.Insert(command_ids[i], i);
+        handlers.push_back(&NoopService::Noop);
+        handler_map.emplace(command_ids[i], &NoopService::Noop);
+    }
+
+    // The flat map is how handlers were looked up before the command table
+    const double table_rate = BenchmarkDispatch(
+        NUM_REQUESTS, [&](u32 command_id) { return handlers[*table.Find(command_id)]; });
+    const double map_rate = BenchmarkDispatch(
+        NUM_REQUESTS, [&](u32 command_id) { return handler_map.find(command_id)->second; });
+
+    printf("CommandTable dispatch: %.0f requests/s\n", table_rate);
+    printf("flat_map dispatch: %.0f requests/s\n", map_rate);
+}
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/hle/service/server_executor_state.h"
+
+namespace {
+struct FakeServer {
+    int id;
+};
+
+using State = Service::ServerExecutorState<FakeServer>;
+} // Anonymous namespace
+
+TEST_CASE("ServerExecutorState[Adopt]", "[core]") {
+    State state;
+    FakeServer first{1};
+    FakeServer second{2};
+    REQUIRE(state.BeginWait().empty());
+    state.EndWait();
+
+    state.Adopt(&first);
+    state.Adopt(&second);
+    REQUIRE(state.BeginWait() == std::vector<FakeServer*>{&first, &second});
+    state.EndWait();
+
+    // A server processing a request is left out of the wait until it's done
+    REQUIRE(state.BeginProcess(&first));
+    REQUIRE(state.BeginWait() == std::vector<FakeServer*>{&second});
+    state.EndWait();
+    state.EndProcess(&first);
+    REQUIRE(state.BeginWait() == std::vector<FakeServer*>{&first, &second});
+    state.EndWait();
+}
+
+TEST_CASE("ServerExecutorState[Release]", "[core]") {
+    State state;
+    FakeServer server{1};
+    FakeServer unknown{2};
+    REQUIRE(!state.BeginRelease(&unknown));
+
+    state.Adopt(&server);
+    REQUIRE(state.BeginWait() == std::vector<FakeServer*>{&server});
+    REQUIRE(state.BeginRelease(&server));
+    // The waiting worker still refers to the server
+    REQUIRE(!state.TryEndRelease(&server));
+    state.EndWait();
+    // A request received by that wait is dropped, the server is going away
+    REQUIRE(!state.BeginProcess(&server));
+    REQUIRE(state.BeginWait().empty());
+    state.EndWait();
+    REQUIRE(state.TryEndRelease(&server));
+    REQUIRE(!state.Contains(&server));
+    REQUIRE(state.Empty());
+}
+
+TEST_CASE("ServerExecutorState[ReleaseInFlight]", "[core]") {
+    State state;
+    FakeServer server{1};
+    state.Adopt(&server);
+    REQUIRE(state.BeginProcess(&server));
+    REQUIRE(state.BeginRelease(&server));
+    REQUIRE(!state.TryEndRelease(&server));
+    state.EndProcess(&server);
+    REQUIRE(state.TryEndRelease(&server));
+    REQUIRE(state.Empty());
+}
+
+TEST_CASE("ServerExecutorState[Shutdown]", "[core]") {
+    // Same locking as ServerExecutor, Release must not return while a request is processed
+    std::mutex mutex;
+    std::condition_variable condition;
+    State state;
+    FakeServer server{1};
+    std::vector<FakeServer*> waited;
+    bool is_started{};
+    std::atomic<bool> is_processing{};
+    std::atomic<bool> is_processed{};
+    state.Adopt(&server);
+
+    // Catch2 assertions aren't thread safe, the worker only records what it saw
+    std::jthread worker([&] {
+        std::unique_lock lk{mutex};
+        waited = state.BeginWait();
+        state.EndWait();
+        is_started = state.BeginProcess(&server);
+        lk.unlock();
+        is_processing = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        is_processed = true;
+        lk.lock();
+        state.EndProcess(&server);
+        condition.notify_all();
+    });
+
+    while (!is_processing) {
+        std::this_thread::yield();
+    }
+    {
+        std::unique_lock lk{mutex};
+        REQUIRE(state.BeginRelease(&server));
+        condition.wait(lk, [&] { return state.TryEndRelease(&server); });
+    }
+    worker.join();
+    REQUIRE(waited == std::vector<FakeServer*>{&server});
+    REQUIRE(is_started);
+    REQUIRE(is_processed);
+    REQUIRE(state.Empty());
+}
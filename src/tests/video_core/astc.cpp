@@ -0,0 +1,265 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/textures/astc.h"
+
+namespace {
+struct BlockSize {
+    u32 width;
+    u32 height;
+};
+
+constexpr std::array BLOCK_SIZES{
+    BlockSize{4, 4},   BlockSize{5, 4},  BlockSize{5, 5},   BlockSize{6, 5},
+    BlockSize{6, 6},   BlockSize{8, 5},  BlockSize{8, 6},   BlockSize{8, 8},
+    BlockSize{10, 5},  BlockSize{10, 6}, BlockSize{10, 8},  BlockSize{10, 10},
+    BlockSize{12, 10}, BlockSize{12, 12},
+};
+
+using Block = std::array<u8, 16>;
+using Texels = std::array<u32, 12 * 12>;
+
+/// Generates random blocks with valid LDR encodings, the decoder asserts on invalid ones.
+class BlockGenerator {
+public:
+    explicit BlockGenerator(u32 seed) : rng{seed} {}
+
+    Block Generate(BlockSize size) {
+        while (true) {
+            Block block;
+            std::ranges::generate(block, [&] { return static_cast<u8>(rng()); });
+            if (MakeValid(block, size)) {
+                return block;
+            }
+        }
+    }
+
+private:
+    bool MakeValid(Block& block, BlockSize size) {
+        // Weight grid layouts 0 to 4 of the block mode table (C.2.8), selected by bits 0 and 1
+        u32 mode = Bits(block, 0, 11);
+        if ((mode & 3) == 0) {
+            mode |= 1;
+            SetBits(block, 0, 11, mode);
+        }
+        const u32 a = (mode >> 5) & 3;
+        const u32 b = (mode >> 7) & 3;
+        u32 grid_width;
+        u32 grid_height;
+        if ((mode & 0xc) == 0) {
+            grid_width = b + 4;
+            grid_height = a + 2;
+        } else if ((mode & 0xc) == 0x4) {
+            grid_width = b + 8;
+            grid_height = a + 2;
+        } else if ((mode & 0xc) == 0x8) {
+            grid_width = a + 2;
+            grid_height = b + 8;
+        } else if ((mode & 0x100) == 0) {
+            grid_width = a + 2;
+            grid_height = (b & 1) + 6;
+        } else {
+            grid_width = (b & 1) + 2;
+            grid_height = a + 2;
+        }
+        const bool dual_plane = (mode & 0x400) != 0;
+        const bool high_precision = (mode & 0x200) != 0;
+        const u32 range = ((mode >> 4) & 1) | ((mode & 3) << 1);
+        const u32 num_weights = grid_width * grid_height * (dual_plane ? 2 : 1);
+        const u32 weight_bits = SequenceBits(high_precision ? range + 4 : range - 2, num_weights);
+        if (grid_width > size.width || grid_height > size.height || num_weights > 64 ||
+            weight_bits < 24 || weight_bits > 96) {
+            return false;
+        }
+
+        // Every partition uses the same LDR color endpoint mode
+        static constexpr std::array ldr_modes{0U, 1U, 4U, 5U, 6U, 8U, 9U, 10U, 12U, 13U};
+        const u32 num_partitions = Bits(block, 11, 2) + 1;
+        const u32 endpoint_mode = ldr_modes[rng() % ldr_modes.size()];
+        if (num_partitions == 4 && dual_plane) {
+            return false;
+        }
+        u32 header_bits = 13;
+        if (num_partitions == 1) {
+            SetBits(block, header_bits, 4, endpoint_mode);
+            header_bits += 4;
+        } else {
+            header_bits += 10;
+            SetBits(block, header_bits, 6, endpoint_mode << 2);
+            header_bits += 6;
+        }
+        const u32 num_values = num_partitions * ((endpoint_mode >> 2) + 1) * 2;
+        const u32 color_bits = 128 - weight_bits - header_bits - (dual_plane ? 2 : 0);
+        return color_bits >= (13 * num_values + 4) / 5;
+    }
+
+    /// Returns the size of an integer sequence of the given weight range index (C.2.17).
+    static u32 SequenceBits(u32 range_index, u32 count) {
+        // Bits, trits and quints of the ranges of table C.2.7
+        static constexpr std::array<std::array<u32, 3>, 12> encodings{{
+            {1, 0, 0}, {0, 1, 0}, {2, 0, 0}, {0, 0, 1}, {1, 1, 0}, {3, 0, 0},
+            {1, 0, 1}, {2, 1, 0}, {4, 0, 0}, {2, 0, 1}, {3, 1, 0}, {5, 0, 0},
+        }};
+        const auto [bits, trits, quints] = encodings[range_index];
+        return bits * count + trits * ((8 * count + 4) / 5) + quints * ((7 * count + 2) / 3);
+    }
+
+    static u32 Bits(const Block& block, u32 offset, u32 count) {
+        u32 value = 0;
+        for (u32 i = 0; i < count; ++i) {
+            value |= ((block[(offset + i) / 8] >> ((offset + i) % 8)) & 1) << i;
+        }
+        return value;
+    }
+
+    static void SetBits(Block& block, u32 offset, u32 count, u32 value) {
+        for (u32 i = 0; i < count; ++i) {
+            const u32 bit = offset + i;
+            block[bit / 8] = static_cast<u8>((block[bit / 8] & ~(1U << (bit % 8))) |
+                                             (((value >> i) & 1) << (bit % 8)));
+        }
+    }
+
+    std::mt19937 rng;
+};
+
+/// The original per-texel weight infill (C.2.18), written for clarity rather than speed.
+void InfillTexelWeightsReference(u32 (&out)[2][144],
+                                 const Tegra::Texture::ASTC::DecodedBlock& block, u32 block_width,
+                                 u32 block_height) {
+    const u32 Ds = (1024 + (block_width / 2)) / (block_width - 1);
+    const u32 Dt = (1024 + (block_height / 2)) / (block_height - 1);
+    const u32 num_weights = block.grid_width * block.grid_height;
+
+    for (u32 plane = 0; plane < (block.dual_plane ? 2U : 1U); plane++) {
+        for (u32 t = 0; t < block_height; t++) {
+            for (u32 s = 0; s < block_width; s++) {
+                const u32 gs = (Ds * s * (block.grid_width - 1) + 32) >> 6;
+                const u32 gt = (Dt * t * (block.grid_height - 1) + 32) >> 6;
+
+                const u32 js = gs >> 4;
+                const u32 fs = gs & 0xF;
+                const u32 jt = gt >> 4;
+                const u32 ft = gt & 0x0F;
+
+                const u32 w11 = (fs * ft + 8) >> 4;
+                const u32 w10 = ft - w11;
+                const u32 w01 = fs - w11;
+                const u32 w00 = 16 - fs - ft + w11;
+
+                const u32 v0 = js + jt * block.grid_width;
+                const auto find_texel = [&](u32 index) {
+                    return index < num_weights ? block.weights[plane][index] : 0;
+                };
+                const u32 p00 = find_texel(v0);
+                const u32 p01 = find_texel(v0 + 1);
+                const u32 p10 = find_texel(v0 + block.grid_width);
+                const u32 p11 = find_texel(v0 + block.grid_width + 1);
+
+                out[plane][t * block_width + s] =
+                    (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
+            }
+        }
+    }
+}
+
+/// Decompresses a block with the original per-texel infill and interpolation, the optimized
+/// decoder must match it bit for bit.
+void DecompressBlockReference(std::span<const u8, 16> data, u32 block_width, u32 block_height,
+                              std::span<u32, 12 * 12> output) {
+    Tegra::Texture::ASTC::DecodedBlock block;
+    if (!Tegra::Texture::ASTC::DecodeBlock(data, block_width, block_height, block)) {
+        // Void extent blocks are not interpolated
+        Tegra::Texture::ASTC::DecompressBlock(data, block_width, block_height, output);
+        return;
+    }
+
+    u32 weights[2][144];
+    InfillTexelWeightsReference(weights, block, block_width, block_height);
+
+    for (u32 texel = 0; texel < block_width * block_height; texel++) {
+        const u32 partition = block.num_partitions > 1 ? block.texel_partitions[texel] : 0;
+        std::array<u32, 4> pixel;
+        for (u32 c = 0; c < 4; c++) {
+            const u32 C0 = block.endpoints[partition][0][c] * 0x101U;
+            const u32 C1 = block.endpoints[partition][1][c] * 0x101U;
+
+            const u32 plane = block.dual_plane && ((block.plane_index + 1) & 3) == c ? 1 : 0;
+            const u32 weight = weights[plane][texel];
+            const u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
+            if (C == 65535) {
+                pixel[c] = 255;
+            } else {
+                pixel[c] = static_cast<u32>(255.0 * (static_cast<double>(C) / 65536.0) + 0.5);
+            }
+        }
+        // Channels are stored as A, R, G, B and packed as R8G8B8A8
+        output[texel] = pixel[1] | pixel[2] << 8 | pixel[3] << 16 | pixel[0] << 24;
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("ASTC[Equivalence]", "[video_core]") {
+    // Random encodings cover every weight range, partition count and dual plane channel
+    constexpr size_t NUM_BLOCKS = 1 << 12;
+    BlockGenerator generator{0xe9a1};
+
+    for (const BlockSize size : BLOCK_SIZES) {
+        const size_t num_texels = size.width * size.height;
+        for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+            const Block block = generator.Generate(size);
+            Texels expected;
+            Texels result;
+            DecompressBlockReference(block, size.width, size.height, expected);
+            Tegra::Texture::ASTC::DecompressBlock(block, size.width, size.height, result);
+
+            INFO("Block " << i << " of size " << size.width << "x" << size.height);
+            REQUIRE(std::ranges::equal(std::span(result).first(num_texels),
+                                       std::span(expected).first(num_texels)));
+        }
+    }
+}
+
+TEST_CASE("ASTC[Benchmark]", "[video_core][.benchmark]") {
+    constexpr size_t NUM_BLOCKS = 1 << 16;
+    BlockGenerator generator{0xa57c};
+    std::vector<Block> blocks(NUM_BLOCKS);
+    std::vector<Texels> expected(NUM_BLOCKS);
+    std::vector<Texels> result(NUM_BLOCKS);
+
+    for (const BlockSize size : BLOCK_SIZES) {
+        for (Block& block : blocks) {
+            block = generator.Generate(size);
+        }
+        const auto run = [&](auto&& decompress, std::vector<Texels>& output) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+                decompress(blocks[i], size.width, size.height, output[i]);
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return static_cast<double>(NUM_BLOCKS) / elapsed.count();
+        };
+        const double reference_rate = run(DecompressBlockReference, expected);
+        const double optimized_rate = run(Tegra::Texture::ASTC::DecompressBlock, result);
+        std::printf("ASTC %ux%u: reference %.0f blocks/s, optimized %.0f blocks/s\n", size.width,
+                    size.height, reference_rate, optimized_rate);
+
+        const size_t num_texels = size.width * size.height;
+        for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+            REQUIRE(std::ranges::equal(std::span(result[i]).first(num_texels),
+                                       std::span(expected[i]).first(num_texels)));
+        }
+    }
+}
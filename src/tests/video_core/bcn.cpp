@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <bc_decoder.h>
+
+#include "common/common_types.h"
+#include "common/settings_enums.h"
+#include "video_core/textures/bcn.h"
+
+namespace {
+using Block = std::array<u8, 16>;
+using Texels = std::array<u8, 4 * 4 * 4>;
+using Color = std::array<int, 4>;
+
+constexpr std::array QUALITIES{
+    Settings::Bc7Quality::Fast,
+    Settings::Bc7Quality::Medium,
+    Settings::Bc7Quality::High,
+};
+
+/// Writes and reads BC7 blocks, least significant bit first.
+class BlockBits {
+public:
+    explicit BlockBits(const Block& block_ = {}) : block{block_} {}
+
+    void Write(u32 value, u32 count) {
+        for (u32 i = 0; i < count; ++i, ++offset) {
+            block[offset / 8] = static_cast<u8>(block[offset / 8] | ((value >> i) & 1)
+                                                                        << (offset % 8));
+        }
+    }
+
+    u32 Read(u32 count) {
+        u32 value = 0;
+        for (u32 i = 0; i < count; ++i, ++offset) {
+            value |= ((block[offset / 8] >> (offset % 8)) & 1U) << i;
+        }
+        return value;
+    }
+
+    Block block;
+
+private:
+    u32 offset = 0;
+};
+
+Texels Decode(const Block& block) {
+    Texels texels{};
+    bcn::DecodeBc7(block.data(), texels.data(), 0, 0, 4, 4);
+    return texels;
+}
+
+double PSNR(std::span<const u8> expected, std::span<const u8> result) {
+    double squared_error = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const double difference = static_cast<double>(expected[i]) - result[i];
+        squared_error += difference * difference;
+    }
+    if (squared_error == 0.0) {
+        return 100.0;
+    }
+    const double mse = squared_error / static_cast<double>(expected.size());
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+u32 Mode(const Block& block) {
+    return static_cast<u32>(std::countr_zero(block[0]));
+}
+
+/// Returns the partition of a block with more than one subset.
+u32 Partition(const Block& block) {
+    BlockBits bits{block};
+    const u32 mode = Mode(block);
+    bits.Read(mode + 1);
+    return bits.Read(mode == 0 ? 4 : 6);
+}
+
+/// Returns the subset of each texel of a partition, by decoding a block where every subset has
+/// its own flat color.
+std::array<u32, 16> PartitionSubsets(u32 num_subsets, u32 partition) {
+    BlockBits bits;
+    if (num_subsets == 2) {
+        // Mode 1, six bit endpoints and a shared p-bit per subset
+        bits.Write(1U << 1, 2);
+        bits.Write(partition, 6);
+        for (u32 channel = 0; channel < 3; ++channel) {
+            for (u32 endpoint = 0; endpoint < 4; ++endpoint) {
+                bits.Write(endpoint < 2 ? 0 : 63, 6);
+            }
+        }
+        bits.Write(0, 1);
+        bits.Write(1, 1);
+    } else {
+        // Mode 2, five bit endpoints without p-bits
+        bits.Write(1U << 2, 3);
+        bits.Write(partition, 6);
+        for (u32 channel = 0; channel < 3; ++channel) {
+            for (u32 endpoint = 0; endpoint < 6; ++endpoint) {
+                bits.Write((endpoint / 2) * 15, 5);
+            }
+        }
+    }
+    const Texels texels = Decode(bits.block);
+    std::array<u32, 16> subsets;
+    for (u32 texel = 0; texel < 16; ++texel) {
+        subsets[texel] = (texels[texel * 4] * (num_subsets - 1) + 127) / 255;
+    }
+    return subsets;
+}
+
+/// Builds a block where the texels of each subset lie on their own line, so only a partitioned
+/// mode with the right partition can encode it well.
+Texels MakePartitionedTexels(std::span<const u32, 16> subsets, bool has_alpha) {
+    static constexpr std::array<Color, 3> bases{{
+        {20, 100, 200, 250},
+        {200, 30, 60, 40},
+        {90, 220, 20, 255},
+    }};
+    static constexpr std::array<Color, 3> directions{{
+        {12, 2, -5, -20},
+        {-4, 11, 6, 25},
+        {5, -6, 13, 0},
+    }};
+    std::array<int, 3> steps{};
+    Texels texels;
+    for (u32 texel = 0; texel < 16; ++texel) {
+        const u32 subset = subsets[texel];
+        const int step = steps[subset]++ % 4;
+        for (u32 channel = 0; channel < 4; ++channel) {
+            const int value = bases[subset][channel] + step * directions[subset][channel];
+            texels[texel * 4 + channel] = static_cast<u8>(std::clamp(value, 0, 255));
+        }
+        if (!has_alpha) {
+            texels[texel * 4 + 3] = 255;
+        }
+    }
+    return texels;
+}
+
+Block Encode(const Texels& texels, Settings::Bc7Quality quality) {
+    Block block;
+    Tegra::Texture::BCN::CompressBC7(texels, 4, 4, 1, block, quality);
+    return block;
+}
+} // Anonymous namespace
+
+TEST_CASE("BC7[RoundTrip]", "[video_core]") {
+    constexpr u32 SIZE = 64;
+    std::mt19937 rng{0xbc7};
+    std::vector<u8> image(SIZE * SIZE * 4);
+    for (u32 y = 0; y < SIZE; ++y) {
+        for (u32 x = 0; x < SIZE; ++x) {
+            // Smooth gradients with some noise and a few hard edges
+            const int noise = static_cast<int>(rng() % 9) - 4;
+            const bool edge = ((x / 12) + (y / 20)) % 2 == 0;
+            const Color color{
+                static_cast<int>(x * 4) + noise,
+                static_cast<int>(y * 3) + (edge ? 60 : 0),
+                static_cast<int>((x + y) * 2) - noise,
+                edge ? 255 : static_cast<int>(128 + x),
+            };
+            for (u32 channel = 0; channel < 4; ++channel) {
+                image[(y * SIZE + x) * 4 + channel] =
+                    static_cast<u8>(std::clamp(color[channel], 0, 255));
+            }
+        }
+    }
+
+    double previous_psnr = 0.0;
+    for (const Settings::Bc7Quality quality : QUALITIES) {
+        std::vector<u8> compressed(SIZE * SIZE);
+        Tegra::Texture::BCN::CompressBC7(image, SIZE, SIZE, 1, compressed, quality);
+
+        std::vector<u8> decoded(image.size());
+        for (u32 y = 0; y < SIZE; y += 4) {
+            for (u32 x = 0; x < SIZE; x += 4) {
+                const u8* const block = compressed.data() + ((y / 4) * (SIZE / 4) + x / 4) * 16;
+                bcn::DecodeBc7(block, decoded.data() + (y * SIZE + x) * 4, x, y, SIZE, SIZE);
+            }
+        }
+        const double psnr = PSNR(image, decoded);
+        INFO("Quality " << static_cast<u32>(quality) << ": " << psnr << " dB");
+        REQUIRE(psnr > 38.0);
+        // Higher qualities only try more candidates, they can't do worse
+        REQUIRE(psnr >= previous_psnr);
+        previous_psnr = psnr;
+    }
+}
+
+TEST_CASE("BC7[ModeSelection]", "[video_core]") {
+    // A single line fits mode 6 at every quality
+    Texels gradient;
+    for (u32 texel = 0; texel < 16; ++texel) {
+        gradient[texel * 4 + 0] = static_cast<u8>(texel * 16);
+        gradient[texel * 4 + 1] = static_cast<u8>(255 - texel * 12);
+        gradient[texel * 4 + 2] = static_cast<u8>(64 + texel * 8);
+        gradient[texel * 4 + 3] = static_cast<u8>(255 - texel * 4);
+    }
+    for (const Settings::Bc7Quality quality : QUALITIES) {
+        const Block block = Encode(gradient, quality);
+        REQUIRE(Mode(block) == 6);
+        REQUIRE(PSNR(gradient, Decode(block)) > 40.0);
+    }
+
+    // Fast never partitions
+    const std::array<u32, 16> subsets = PartitionSubsets(2, 13);
+    const Texels texels = MakePartitionedTexels(subsets, false);
+    REQUIRE(Mode(Encode(texels, Settings::Bc7Quality::Fast)) == 6);
+}
+
+TEST_CASE("BC7[PartitionSelection]", "[video_core]") {
+    for (const bool has_alpha : {false, true}) {
+        for (u32 partition = 0; partition < 64; ++partition) {
+            const std::array<u32, 16> subsets = PartitionSubsets(2, partition);
+            const Texels texels = MakePartitionedTexels(subsets, has_alpha);
+            const Block fast = Encode(texels, Settings::Bc7Quality::Fast);
+            const Block high = Encode(texels, Settings::Bc7Quality::High);
+            const u32 mode = Mode(high);
+
+            INFO("Two subsets, partition " << partition << ", alpha " << has_alpha);
+            REQUIRE((has_alpha ? mode == 7 : (mode == 1 || mode == 3)));
+            REQUIRE(Partition(high) == partition);
+            REQUIRE(PSNR(texels, Decode(high)) > 40.0);
+            REQUIRE(PSNR(texels, Decode(high)) > PSNR(texels, Decode(fast)));
+        }
+    }
+    // Some three subset shapes are fit as well by two lines, then a two subset mode may win
+    u32 num_three_subsets = 0;
+    for (u32 partition = 0; partition < 64; ++partition) {
+        const std::array<u32, 16> subsets = PartitionSubsets(3, partition);
+        const Texels texels = MakePartitionedTexels(subsets, false);
+        const Block high = Encode(texels, Settings::Bc7Quality::High);
+        const u32 mode = Mode(high);
+
+        INFO("Three subsets, partition " << partition << ", mode " << mode);
+        REQUIRE(mode != 6);
+        if (mode == 0 || mode == 2) {
+            REQUIRE(Partition(high) == partition);
+            ++num_three_subsets;
+        }
+        REQUIRE(PSNR(texels, Decode(high)) > 40.0);
+    }
+    REQUIRE(num_three_subsets >= 56);
+}
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "video_core/buffer_cache/buffer_page_table.h"
+
+namespace {
+constexpr u64 NUM_PAGES = 1ULL << 18;
+constexpr u64 LEAF_BITS = 9;
+
+using PageTable = VideoCommon::BufferPageTable<NUM_PAGES, LEAF_BITS>;
+using Common::SlotId;
+} // Anonymous namespace
+
+TEST_CASE("BufferPageTable[Lookup]", "[video_core]") {
+    auto table = std::make_unique<PageTable>();
+    REQUIRE(!(*table)[0]);
+    REQUIRE(!(*table)[NUM_PAGES - 1]);
+    REQUIRE(table->NumCommittedLeaves() == 0);
+
+    table->Set(1000, SlotId{3});
+    table->Set(1001, SlotId{3});
+    table->Set(NUM_PAGES - 1, SlotId{7});
+    REQUIRE((*table)[1000] == SlotId{3});
+    REQUIRE((*table)[1001] == SlotId{3});
+    REQUIRE(!(*table)[1002]);
+    REQUIRE((*table)[NUM_PAGES - 1] == SlotId{7});
+    REQUIRE(table->NumCommittedLeaves() == 2);
+
+    // Replacing a buffer keeps the leaf, clearing an empty page doesn't commit one
+    table->Set(1000, SlotId{4});
+    table->Set(5000, SlotId{});
+    REQUIRE((*table)[1000] == SlotId{4});
+    REQUIRE(table->NumCommittedLeaves() == 2);
+}
+
+TEST_CASE("BufferPageTable[Release]", "[video_core]") {
+    auto table = std::make_unique<PageTable>();
+    const u64 base_usage = table->MemoryUsage();
+    for (u64 page = 0; page < 1024; ++page) {
+        table->Set(page, SlotId{1});
+    }
+    REQUIRE(table->NumCommittedLeaves() == 2);
+    REQUIRE(table->MemoryUsage() > base_usage);
+
+    for (u64 page = 0; page < 512; ++page) {
+        table->Set(page, SlotId{});
+    }
+    REQUIRE(table->NumCommittedLeaves() == 1);
+    REQUIRE(!(*table)[0]);
+    REQUIRE((*table)[512] == SlotId{1});
+
+    for (u64 page = 512; page < 1024; ++page) {
+        table->Set(page, SlotId{});
+    }
+    REQUIRE(table->NumCommittedLeaves() == 0);
+    REQUIRE(table->MemoryUsage() == base_usage);
+    REQUIRE(!(*table)[512]);
+}
+
+TEST_CASE("BufferPageTable[Benchmark]", "[video_core][.benchmark]") {
+    // Buffers clustered in a few regions of the address space, like games map them
+    constexpr size_t NUM_QUERIES = 1ULL << 24;
+    std::mt19937_64 rng{42};
+    auto table = std::make_unique<PageTable>();
+    auto dense = std::make_unique<std::array<SlotId, NUM_PAGES>>();
+    std::vector<u64> queries(NUM_QUERIES);
+    for (u32 region = 0; region < 8; ++region) {
+        const u64 base = rng() % (NUM_PAGES - 4096);
+        for (u64 page = base; page < base + 4096; ++page) {
+            table->Set(page, SlotId{region});
+            (*dense)[page] = SlotId{region};
+        }
+    }
+    for (u64& query : queries) {
+        query = rng() % NUM_PAGES;
+    }
+
+    const auto run = [&](const char* name, auto&& lookup) {
+        u64 hits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const u64 page : queries) {
+            hits += static_cast<bool>(lookup(page)) ? 1 : 0;
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%s: %.0f queries/s (%llu hits)\n", name,
+                    static_cast<double>(NUM_QUERIES) / elapsed.count(),
+                    static_cast<unsigned long long>(hits));
+        return hits;
+    };
+    const u64 sparse_hits = run("sparse", [&](u64 page) { return (*table)[page]; });
+    const u64 dense_hits = run("dense", [&](u64 page) { return (*dense)[page]; });
+    std::printf("sparse table memory: %llu bytes, dense: %zu bytes\n",
+                static_cast<unsigned long long>(table->MemoryUsage()), sizeof(*dense));
+    REQUIRE(sparse_hits == dense_hits);
+}
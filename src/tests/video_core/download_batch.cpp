@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "video_core/buffer_cache/download_batch.h"
+
+namespace {
+using VideoCommon::BufferCopy;
+using Download = std::pair<BufferCopy, u32>;
+
+Download MakeDownload(u32 buffer, u64 offset, u64 size) {
+    return {BufferCopy{.src_offset = offset, .dst_offset = 0, .size = size}, buffer};
+}
+} // Anonymous namespace
+
+TEST_CASE("CoalesceDownloads[Merge]", "[video_core]") {
+    std::vector<Download> downloads{
+        MakeDownload(2, 0x100, 0x10), MakeDownload(1, 0x40, 0x40), MakeDownload(1, 0x0, 0x40),
+        MakeDownload(1, 0x60, 0x40),  MakeDownload(1, 0x200, 0x8), MakeDownload(2, 0x110, 0x10),
+        MakeDownload(2, 0x108, 0x4),
+    };
+    const u64 total_size_bytes = VideoCommon::CoalesceDownloads(downloads);
+    REQUIRE(downloads.size() == 3);
+
+    REQUIRE(downloads[0].second == 1);
+    REQUIRE(downloads[0].first.src_offset == 0x0);
+    REQUIRE(downloads[0].first.size == 0xa0);
+    REQUIRE(downloads[0].first.dst_offset == 0);
+
+    // Separated by a gap, merging would write stale data over guest memory
+    REQUIRE(downloads[1].second == 1);
+    REQUIRE(downloads[1].first.src_offset == 0x200);
+    REQUIRE(downloads[1].first.size == 0x8);
+    REQUIRE(downloads[1].first.dst_offset == 0xc0);
+
+    REQUIRE(downloads[2].second == 2);
+    REQUIRE(downloads[2].first.src_offset == 0x100);
+    REQUIRE(downloads[2].first.size == 0x20);
+    REQUIRE(downloads[2].first.dst_offset == 0x100);
+
+    REQUIRE(total_size_bytes == 0x140);
+}
+
+TEST_CASE("CoalesceDownloads[Empty]", "[video_core]") {
+    std::vector<Download> downloads;
+    REQUIRE(VideoCommon::CoalesceDownloads(downloads) == 0);
+    REQUIRE(downloads.empty());
+}
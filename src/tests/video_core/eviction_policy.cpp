@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/literals.h"
+#include "video_core/texture_cache/eviction_policy.h"
+#include "video_core/texture_cache/image_base.h"
+
+namespace {
+using namespace Common::Literals;
+using VideoCommon::EvictionPolicy;
+using VideoCommon::ImageBase;
+using VideoCommon::ImageFlagBits;
+
+ImageBase MakeImage(GPUVAddr gpu_addr, u32 size, u64 last_use_tick) {
+    ImageBase image{VideoCommon::NullImageParams{}};
+    image.gpu_addr = gpu_addr;
+    image.guest_size_bytes = size;
+    image.flags = ImageFlagBits{};
+    image.last_use_tick = last_use_tick;
+    return image;
+}
+} // Anonymous namespace
+
+TEST_CASE("EvictionPolicy[Score]", "[video_core]") {
+    const ImageBase plain = MakeImage(0x10000, 4_MiB, 100);
+    const ImageBase older = MakeImage(0x20000, 4_MiB, 50);
+    const ImageBase larger = MakeImage(0x30000, 16_MiB, 100);
+    REQUIRE(EvictionPolicy::Score(older, 200) > EvictionPolicy::Score(plain, 200));
+    REQUIRE(EvictionPolicy::Score(larger, 200) > EvictionPolicy::Score(plain, 200));
+
+    // Images that are costly to load back are kept longer
+    ImageBase converted = plain;
+    converted.flags |= ImageFlagBits::Converted;
+    ImageBase render_target = plain;
+    render_target.flags |= ImageFlagBits::GpuModified;
+    REQUIRE(EvictionPolicy::Score(converted, 200) < EvictionPolicy::Score(plain, 200));
+    REQUIRE(EvictionPolicy::Score(render_target, 200) < EvictionPolicy::Score(plain, 200));
+
+    // Images used every 80 frames are expected back, until they miss their usual gap
+    ImageBase periodic = MakeImage(0x40000, 4_MiB, 0);
+    for (u64 tick = 80; tick <= 400; tick += 80) {
+        EvictionPolicy::RecordUse(periodic, tick);
+    }
+    REQUIRE(periodic.reuse_distance == 80);
+    REQUIRE(EvictionPolicy::Score(periodic, 500) < EvictionPolicy::Score(plain, 200));
+    REQUIRE(EvictionPolicy::Score(periodic, 600) > EvictionPolicy::Score(plain, 200));
+}
+
+TEST_CASE("EvictionPolicy[Thrash]", "[video_core]") {
+    EvictionPolicy policy;
+    const ImageBase evicted = MakeImage(0x10000, 4_MiB, 100);
+    policy.RecordEviction(evicted, 200);
+    REQUIRE(policy.Stats().evicted_images == 1);
+    REQUIRE(policy.Stats().evicted_bytes == 4_MiB);
+
+    // A different image at the same address is not the same image
+    ImageBase other = MakeImage(0x10000, 8_MiB, 210);
+    REQUIRE(!policy.RecordCreation(other, 210));
+
+    policy.RecordEviction(evicted, 220);
+    ImageBase recreated = MakeImage(0x10000, 4_MiB, 230);
+    REQUIRE(policy.RecordCreation(recreated, 230));
+    REQUIRE(recreated.thrash_count == 1);
+    REQUIRE(policy.Stats().thrashed_images == 1);
+    REQUIRE(policy.Stats().thrashed_bytes == 4_MiB);
+
+    // Thrashed images are kept longer
+    REQUIRE(EvictionPolicy::Score(recreated, 400) < EvictionPolicy::Score(evicted, 300));
+
+    // Evictions are forgotten after the thrash window
+    policy.RecordEviction(recreated, 240);
+    policy.Tick(EvictionPolicy::THRASH_WINDOW_FRAMES * 4);
+    ImageBase late = MakeImage(0x10000, 4_MiB, 0);
+    REQUIRE(!policy.RecordCreation(late, EvictionPolicy::THRASH_WINDOW_FRAMES * 4));
+    REQUIRE(policy.Stats().thrashed_images == 1);
+}
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "common/hash.h"
+#include "video_core/texture_cache/image_page_table.h"
+
+namespace {
+using PageTable = VideoCommon::ImagePageTable<u32>;
+
+std::vector<u32> Collect(PageTable& table, u64 first_page, u64 last_page) {
+    std::vector<u32> ids;
+    table.ForEachEntry(first_page, last_page, [&](const PageTable::Entry& entry) {
+        ids.insert(ids.end(), entry.begin(), entry.end());
+    });
+    return ids;
+}
+} // Anonymous namespace
+
+TEST_CASE("ImagePageTable[Lookup]", "[video_core]") {
+    PageTable table;
+    REQUIRE(table.Find(0) == nullptr);
+
+    table[5].push_back(1);
+    table[5].push_back(2);
+    table[1023].push_back(3);
+    table[1024].push_back(4);
+    table[0x40000].push_back(5);
+
+    REQUIRE(table.Find(5)->size() == 2);
+    REQUIRE(table.Find(6)->empty());
+    REQUIRE(table.Find(2048) == nullptr);
+    REQUIRE(table.Find(0x40001)->empty());
+
+    REQUIRE(Collect(table, 0, 4) == std::vector<u32>{});
+    REQUIRE(Collect(table, 0, 1024) == std::vector<u32>{1, 2, 3, 4});
+    REQUIRE(Collect(table, 1024, 0x3FFFF) == std::vector<u32>{4});
+    REQUIRE(Collect(table, 6, 0x40000) == std::vector<u32>{3, 4, 5});
+
+    table.Find(1024)->clear();
+    REQUIRE(Collect(table, 1000, 2000) == std::vector<u32>{3});
+}
+
+TEST_CASE("ImagePageTable[Overflow]", "[video_core]") {
+    // Pages past the two level table still work, through the hash map
+    constexpr u64 FAR_PAGE = 1ULL << 30;
+    PageTable table;
+    table[FAR_PAGE].push_back(7);
+    table[8].push_back(8);
+
+    REQUIRE(table.Find(FAR_PAGE)->front() == 7);
+    REQUIRE(table.Find(FAR_PAGE + 1) == nullptr);
+    REQUIRE(Collect(table, FAR_PAGE - 2, FAR_PAGE + 2) == std::vector<u32>{7});
+    REQUIRE(Collect(table, 0, 16) == std::vector<u32>{8});
+}
+
+TEST_CASE("ImagePageTable[Break]", "[video_core]") {
+    PageTable table;
+    for (u32 page = 0; page < 8; ++page) {
+        table[page].push_back(page);
+    }
+
+    std::vector<u32> visited;
+    table.ForEachEntry(0, 7, [&](const PageTable::Entry& entry) {
+        visited.push_back(entry.front());
+        return entry.front() == 2;
+    });
+    REQUIRE(visited == std::vector<u32>{0, 1, 2});
+}
+
+TEST_CASE("ImagePageTable[Benchmark]", "[video_core][.benchmark]") {
+    constexpr size_t NUM_IMAGES = 4096;
+    constexpr size_t NUM_QUERIES = 1 << 22;
+    constexpr u64 PAGE_BITS = 20;
+
+    // Images spread over a 16 GiB device address space, mostly render targets and textures a
+    // few MiB in size, queried mostly at the start of an image like per draw lookups do
+    std::mt19937_64 rng{0x7ab};
+    std::vector<std::pair<u64, u64>> images(NUM_IMAGES);
+    for (auto& [addr, size] : images) {
+        addr = (rng() % (16ULL << 30)) & ~0xFFFULL;
+        size = (rng() % 8 + 1) << 20;
+    }
+    std::vector<std::pair<u64, u64>> queries(4096);
+    for (auto& [addr, size] : queries) {
+        const auto& image = images[rng() % NUM_IMAGES];
+        addr = image.first + (rng() % 4 == 0 ? rng() % image.second : 0);
+        size = rng() % 2 == 0 ? 0x1000 : image.second;
+    }
+
+    PageTable table;
+    std::unordered_map<u64, std::vector<u32>, Common::IdentityHash<u64>> hash_table;
+    for (u32 id = 0; id < NUM_IMAGES; ++id) {
+        const auto [addr, size] = images[id];
+        for (u64 page = addr >> PAGE_BITS; page <= (addr + size - 1) >> PAGE_BITS; ++page) {
+            table[page].push_back(id);
+            hash_table[page].push_back(id);
+        }
+    }
+
+    size_t table_found = 0;
+    const auto table_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        const auto [addr, size] = queries[i % queries.size()];
+        table.ForEachEntry(addr >> PAGE_BITS, (addr + size - 1) >> PAGE_BITS,
+                           [&](const PageTable::Entry& entry) { table_found += entry.size(); });
+    }
+    const std::chrono::duration<double> table_elapsed =
+        std::chrono::steady_clock::now() - table_start;
+
+    size_t hash_found = 0;
+    const auto hash_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        const auto [addr, size] = queries[i % queries.size()];
+        for (u64 page = addr >> PAGE_BITS; page <= (addr + size - 1) >> PAGE_BITS; ++page) {
+            const auto it = hash_table.find(page);
+            if (it != hash_table.end()) {
+                hash_found += it->second.size();
+            }
+        }
+    }
+    const std::chrono::duration<double> hash_elapsed =
+        std::chrono::steady_clock::now() - hash_start;
+
+    REQUIRE(table_found == hash_found);
+    printf("ImagePageTable region queries: %.0f queries/s (hash map: %.0f queries/s)\n",
+           static_cast<double>(NUM_QUERIES) / table_elapsed.count(),
+           static_cast<double>(NUM_QUERIES) / hash_elapsed.count());
+}
@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/device_memory.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/host1x/gpu_device_memory_manager.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/memory_manager.h"
+
+#if defined(ARCHITECTURE_x86_64)
+#include "video_core/macro/macro_jit_x64.h"
+#elif defined(ARCHITECTURE_arm64) && defined(ENABLE_ARM64_MACRO_JIT)
+#include "video_core/macro/macro_jit_arm64.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) ||                                                               \
+    (defined(ARCHITECTURE_arm64) && defined(ENABLE_ARM64_MACRO_JIT))
+
+namespace {
+using Tegra::Engines::Maxwell3D;
+
+#if defined(ARCHITECTURE_x86_64)
+using MacroJIT = Tegra::MacroJITx64;
+#else
+using MacroJIT = Tegra::MacroJITArm64;
+#endif
+
+constexpr u32 MIN_PROGRAM_SIZE = 2;
+constexpr u32 MAX_PROGRAM_SIZE = 48;
+constexpr u32 MACRO_METHOD = 0;
+
+struct MethodCall {
+    u32 method;
+    u32 argument;
+
+    bool operator==(const MethodCall&) const = default;
+};
+
+struct MacroProgram {
+    std::vector<u32> code;
+    std::vector<u32> parameters;
+};
+
+/// Generates random macro programs that are guaranteed to terminate and to fetch exactly the
+/// parameters they are given.
+class MacroGenerator {
+public:
+    explicit MacroGenerator(u32 seed) : rng{seed} {}
+
+    MacroProgram Generate() {
+        using namespace Tegra::Macro;
+
+        const u32 size = Random(MIN_PROGRAM_SIZE, MAX_PROGRAM_SIZE);
+        // The last instruction is always the delay slot of the final exit
+        const u32 exit_index = size - 2;
+
+        MacroProgram program;
+        program.code.reserve(size);
+        size_t num_parameters = 1;
+        // Only the instructions before the first branch or exit are known to run, the rest may be
+        // skipped depending on the registers, so only those fetch parameters
+        bool may_fetch = true;
+        bool next_is_delay_slot = false;
+        for (u32 index = 0; index < size; ++index) {
+            // Branches only jump forward past their delay slot, no instruction runs twice
+            const bool is_delay_slot = next_is_delay_slot;
+            const bool can_branch = !is_delay_slot && index + 2 <= exit_index;
+
+            Opcode opcode{};
+            opcode.raw = static_cast<u32>(rng());
+            opcode.is_exit.Assign(0);
+
+            static constexpr std::array operations{
+                Operation::ALU,
+                Operation::AddImmediate,
+                Operation::ExtractInsert,
+                Operation::ExtractShiftLeftImmediate,
+                Operation::ExtractShiftLeftRegister,
+                Operation::Read,
+                Operation::Branch,
+            };
+            const size_t num_operations = can_branch ? operations.size() : operations.size() - 1;
+            opcode.operation.Assign(operations[Random(0, static_cast<u32>(num_operations - 1))]);
+
+            switch (opcode.operation) {
+            case Operation::ALU: {
+                static constexpr std::array alu_operations{
+                    ALUOperation::Add,    ALUOperation::AddWithCarry,
+                    ALUOperation::Subtract, ALUOperation::SubtractWithBorrow,
+                    ALUOperation::Xor,    ALUOperation::Or,
+                    ALUOperation::And,    ALUOperation::AndNot,
+                    ALUOperation::Nand,
+                };
+                opcode.alu_operation.Assign(
+                    alu_operations[Random(0, static_cast<u32>(alu_operations.size() - 1))]);
+                break;
+            }
+            case Operation::Read:
+                // Reads outside of the register file are not valid
+                opcode.src_a.Assign(0);
+                opcode.immediate.Assign(
+                    static_cast<s32>(Random(0, Maxwell3D::Regs::NUM_REGS - 1)));
+                break;
+            case Operation::Branch:
+                opcode.immediate.Assign(static_cast<s32>(Random(index + 2, exit_index) - index));
+                break;
+            default:
+                break;
+            }
+
+            next_is_delay_slot = false;
+            if (opcode.operation == Operation::Branch) {
+                next_is_delay_slot = true;
+            } else if (!is_delay_slot &&
+                       (index == exit_index || (index + 1 < exit_index && Random(0, 31) == 0))) {
+                opcode.is_exit.Assign(1);
+                next_is_delay_slot = true;
+            }
+            if (opcode.operation != Operation::Branch) {
+                switch (opcode.result_operation) {
+                case ResultOperation::IgnoreAndFetch:
+                case ResultOperation::FetchAndSend:
+                case ResultOperation::FetchAndSetMethod:
+                case ResultOperation::MoveAndSetMethodFetchAndSend:
+                    if (may_fetch) {
+                        ++num_parameters;
+                    } else {
+                        opcode.result_operation.Assign(ResultOperation::MoveAndSend);
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (next_is_delay_slot) {
+                may_fetch = false;
+            }
+            program.code.push_back(opcode.raw);
+        }
+
+        program.parameters.resize(num_parameters);
+        for (u32& parameter : program.parameters) {
+            // Mix small values in, so branches on zero and short shifts are exercised as well
+            parameter = Random(0, 3) == 0 ? Random(0, 31) : static_cast<u32>(rng());
+        }
+        return program;
+    }
+
+    u32 Random(u32 min, u32 max) {
+        return std::uniform_int_distribution<u32>{min, max}(rng);
+    }
+
+private:
+    std::mt19937 rng;
+};
+
+/// Records the methods sent by macros instead of executing them.
+class RecordingSink final : public Tegra::MacroMethodSink {
+public:
+    explicit RecordingSink(Maxwell3D& maxwell3d_) : maxwell3d{maxwell3d_} {}
+
+    void Send(u32 method, u32 argument) override {
+        calls.push_back({method, argument});
+        // Sent values become visible to later reads, like register writes on hardware
+        if (method < Maxwell3D::Regs::NUM_REGS) {
+            maxwell3d.regs.reg_array[method] = argument;
+        }
+    }
+
+    std::vector<MethodCall> calls;
+
+private:
+    Maxwell3D& maxwell3d;
+};
+
+class MacroFixture {
+public:
+    void RandomizeRegisters(MacroGenerator& generator) {
+        for (u32& value : initial_registers) {
+            value = generator.Random(0, 3) == 0 ? 0 : generator.Random(0, 0xffffffff);
+        }
+    }
+
+    template <typename Engine>
+    std::vector<MethodCall> Run(Engine& engine, const MacroProgram& program) {
+        maxwell3d.regs.reg_array = initial_registers;
+        sink.calls.clear();
+        engine.ClearCode(MACRO_METHOD);
+        for (const u32 word : program.code) {
+            engine.AddCode(MACRO_METHOD, word);
+        }
+        engine.Execute(MACRO_METHOD, program.parameters);
+        return sink.calls;
+    }
+
+    Core::System system;
+    Core::DeviceMemory device_memory;
+    Tegra::MaxwellDeviceMemoryManager device_memory_manager{device_memory};
+    Tegra::MemoryManager memory_manager{system, device_memory_manager, 32, 1ULL << 31};
+    Maxwell3D maxwell3d{system, memory_manager};
+    RecordingSink sink{maxwell3d};
+
+    std::array<u32, Maxwell3D::Regs::NUM_REGS> initial_registers{};
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Macro[Differential]", "[video_core]") {
+    constexpr size_t NUM_PROGRAMS = 4096;
+
+    auto fixture = std::make_unique<MacroFixture>();
+    Tegra::MacroInterpreter interpreter{fixture->maxwell3d};
+    MacroJIT jit{fixture->maxwell3d};
+    interpreter.SetMethodSink(&fixture->sink);
+    jit.SetMethodSink(&fixture->sink);
+
+    MacroGenerator generator{0x5eed};
+    for (size_t i = 0; i < NUM_PROGRAMS; ++i) {
+        const MacroProgram program = generator.Generate();
+        fixture->RandomizeRegisters(generator);
+
+        const std::vector<MethodCall> expected = fixture->Run(interpreter, program);
+        const std::vector<MethodCall> result = fixture->Run(jit, program);
+
+        INFO("Program " << i << " with " << program.code.size() << " instructions");
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("Macro[Benchmark]", "[video_core][.benchmark]") {
+    constexpr size_t NUM_PROGRAMS = 256;
+    constexpr size_t NUM_ITERATIONS = 64;
+
+    auto fixture = std::make_unique<MacroFixture>();
+    MacroGenerator generator{0xbe4c};
+    std::vector<MacroProgram> programs(NUM_PROGRAMS);
+    for (MacroProgram& program : programs) {
+        program = generator.Generate();
+    }
+
+    const auto benchmark = [&](const char* name, auto& engine) {
+        // Programs are compiled on their first execution, only steady state execution is timed
+        for (size_t i = 0; i < programs.size(); ++i) {
+            const u32 method = static_cast<u32>(i);
+            for (const u32 word : programs[i].code) {
+                engine.AddCode(method, word);
+            }
+            engine.Execute(method, programs[i].parameters);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t iteration = 0; iteration < NUM_ITERATIONS; ++iteration) {
+            fixture->sink.calls.clear();
+            for (size_t i = 0; i < programs.size(); ++i) {
+                engine.Execute(static_cast<u32>(i), programs[i].parameters);
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double programs_per_second =
+            static_cast<double>(NUM_PROGRAMS * NUM_ITERATIONS) / elapsed.count();
+        printf("Macro %s: %.0f programs/s\n", name, programs_per_second);
+    };
+
+    Tegra::MacroInterpreter interpreter{fixture->maxwell3d};
+    MacroJIT jit{fixture->maxwell3d};
+    interpreter.SetMethodSink(&fixture->sink);
+    jit.SetMethodSink(&fixture->sink);
+    benchmark("interpreter", interpreter);
+    benchmark("JIT", jit);
+}
+
+#endif
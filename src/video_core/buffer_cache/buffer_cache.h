@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <memory>
 #include <numeric>
+#include <utility>
 
 #include "common/range_sets.inc"
 #include "video_core/buffer_cache/buffer_cache_base.h"
@@ -104,6 +105,8 @@ void BufferCache<P>::TickFrame() {
         runtime.FreeDeferredStagingBuffer(buffer);
     }
     async_buffers_death_ring.clear();
+
+    last_frame_download_stats = std::exchange(download_stats, DownloadStats{});
 }
 
 template <class P>
@@ -542,8 +545,6 @@ void BufferCache<P>::CommitAsyncFlushesHigh() {
     }
 
     boost::container::small_vector<std::pair<BufferCopy, BufferId>, 16> downloads;
-    u64 total_size_bytes = 0;
-    u64 largest_copy = 0;
     for (const Common::RangeSet<DAddr>& range_set : committed_gpu_modified_ranges) {
         range_set.ForEach([&](DAddr interval_lower, DAddr interval_upper) {
             const std::size_t size = interval_upper - interval_lower;
@@ -558,21 +559,14 @@ void BufferCache<P>::CommitAsyncFlushesHigh() {
                     [&](u64 device_addr_out, u64 range_size) {
                         const DAddr buffer_addr = buffer.CpuAddr();
                         const auto add_download = [&](DAddr start, DAddr end) {
-                            const u64 new_offset = start - buffer_addr;
-                            const u64 new_size = end - start;
                             downloads.push_back({
                                 BufferCopy{
-                                    .src_offset = new_offset,
-                                    .dst_offset = total_size_bytes,
-                                    .size = new_size,
+                                    .src_offset = start - buffer_addr,
+                                    .dst_offset = 0,
+                                    .size = end - start,
                                 },
                                 buffer_id,
                             });
-                            // Align up to avoid cache conflicts
-                            constexpr u64 align = 64ULL;
-                            constexpr u64 mask = ~(align - 1ULL);
-                            total_size_bytes += (new_size + align - 1) & mask;
-                            largest_copy = std::max(largest_copy, new_size);
                         };
 
                         gpu_modified_ranges.ForEachInRange(device_addr_out, range_size,
@@ -586,22 +580,35 @@ void BufferCache<P>::CommitAsyncFlushesHigh() {
         async_buffers.emplace_back(std::optional<Async_Buffer>{});
         return;
     }
+    // Merge the ranges found through different range sets and tracker pages, so each buffer is
+    // downloaded with one copy command instead of one per range.
+    const u64 total_size_bytes = CoalesceDownloads(downloads);
     auto download_staging = runtime.DownloadStagingBuffer(total_size_bytes, true);
     boost::container::small_vector<BufferCopy, 4> normalized_copies;
+    boost::container::small_vector<BufferCopy, 16> batch;
     runtime.PreCopyBarrier();
-    for (auto& [copy, buffer_id] : downloads) {
-        copy.dst_offset += download_staging.offset;
-        const std::array copies{copy};
-        BufferCopy second_copy{copy};
+    for (auto it = downloads.begin(); it != downloads.end();) {
+        const BufferId buffer_id = it->second;
         Buffer& buffer = slot_buffers[buffer_id];
-        second_copy.src_offset = static_cast<size_t>(buffer.CpuAddr()) + copy.src_offset;
-        const DAddr orig_device_addr = static_cast<DAddr>(second_copy.src_offset);
-        async_downloads.Add(orig_device_addr, copy.size);
-        buffer.MarkUsage(copy.src_offset, copy.size);
-        runtime.CopyBuffer(download_staging.buffer, buffer, copies, false);
-        normalized_copies.push_back(second_copy);
+        batch.clear();
+        for (; it != downloads.end() && it->second == buffer_id; ++it) {
+            BufferCopy& copy = it->first;
+            copy.dst_offset += download_staging.offset;
+            BufferCopy second_copy{copy};
+            second_copy.src_offset = static_cast<size_t>(buffer.CpuAddr()) + copy.src_offset;
+            const DAddr orig_device_addr = static_cast<DAddr>(second_copy.src_offset);
+            async_downloads.Add(orig_device_addr, copy.size);
+            buffer.MarkUsage(copy.src_offset, copy.size);
+            batch.push_back(copy);
+            normalized_copies.push_back(second_copy);
+        }
+        const std::span<const BufferCopy> batch_span(batch.data(), batch.size());
+        runtime.CopyBuffer(download_staging.buffer, buffer, batch_span, false);
+        ++download_stats.batches;
     }
     runtime.PostCopyBarrier();
+    download_stats.bytes += total_size_bytes;
+    download_stats.copies += downloads.size();
     pending_downloads.emplace_back(std::move(normalized_copies));
     async_buffers.emplace_back(download_staging);
 }
@@ -1431,9 +1438,9 @@ void BufferCache<P>::ChangeRegister(BufferId buffer_id) {
     const u64 page_end = Common::DivCeil(device_addr_end, CACHING_PAGESIZE);
     for (u64 page = page_begin; page != page_end; ++page) {
         if constexpr (insert) {
-            page_table[page] = buffer_id;
+            page_table.Set(page, buffer_id);
         } else {
-            page_table[page] = BufferId{};
+            page_table.Set(page, BufferId{});
         }
     }
 }
@@ -1604,6 +1611,9 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, DAddr device_addr, u64
         return;
     }
     MICROPROFILE_SCOPE(GPU_DownloadMemory);
+    download_stats.bytes += total_size_bytes;
+    download_stats.copies += copies.size();
+    ++download_stats.batches;
 
     if constexpr (USE_MEMORY_MAPS) {
         auto download_staging = runtime.DownloadStagingBuffer(total_size_bytes);
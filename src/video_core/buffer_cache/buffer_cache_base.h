@@ -23,6 +23,8 @@
 #include "common/settings.h"
 #include "common/slot_vector.h"
 #include "video_core/buffer_cache/buffer_base.h"
+#include "video_core/buffer_cache/buffer_page_table.h"
+#include "video_core/buffer_cache/download_batch.h"
 #include "video_core/control/channel_state_cache.h"
 #include "video_core/delayed_destruction_ring.h"
 #include "video_core/dirty_flags.h"
@@ -288,6 +290,16 @@ public:
     /// Return true when a CPU region is modified from the CPU
     [[nodiscard]] bool IsRegionCpuModified(DAddr addr, size_t size);
 
+    /// Return the host memory used by the page table, in bytes
+    [[nodiscard]] u64 GetPageTableMemoryUsage() const noexcept {
+        return page_table.MemoryUsage();
+    }
+
+    /// Return the GPU to CPU downloads recorded in the last frame
+    [[nodiscard]] const DownloadStats& GetDownloadStats() const noexcept {
+        return last_frame_download_stats;
+    }
+
     void SetDrawIndirect(
         const Tegra::Engines::DrawManager::IndirectParams* current_draw_indirect_) {
         current_draw_indirect = current_draw_indirect_;
@@ -467,6 +479,9 @@ private:
 
     std::deque<Async_Buffer> async_buffers_death_ring;
 
+    DownloadStats download_stats;
+    DownloadStats last_frame_download_stats;
+
     size_t immediate_buffer_capacity = 0;
     Common::ScratchBuffer<u8> immediate_buffer_alloc;
 
@@ -481,7 +496,7 @@ private:
     u64 critical_memory = 0;
     BufferId inline_buffer_id;
 
-    std::array<BufferId, ((1ULL << 34) >> CACHING_PAGEBITS)> page_table;
+    BufferPageTable<((1ULL << 34) >> CACHING_PAGEBITS), 9> page_table;
     Common::ScratchBuffer<u8> tmp_buffer;
 };
 
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/slot_vector.h"
+
+namespace VideoCommon {
+
+/**
+ * Maps the caching pages of the device address space to the buffer in them.
+ *
+ * Pages are indexed through a two level table. Leaves are committed on the first write of a
+ * buffer to one of their pages and released when their last buffer is removed, until then the
+ * root points them to a shared empty leaf, so a lookup is always two loads and no branches.
+ */
+template <u64 NUM_PAGES, u64 LEAF_BITS>
+class BufferPageTable {
+    static constexpr u64 LEAF_SIZE = 1ULL << LEAF_BITS;
+    static constexpr u64 LEAF_MASK = LEAF_SIZE - 1;
+    static constexpr u64 NUM_LEAVES = (NUM_PAGES + LEAF_SIZE - 1) >> LEAF_BITS;
+
+    using Leaf = std::array<Common::SlotId, LEAF_SIZE>;
+
+public:
+    BufferPageTable() {
+        root.fill(&EMPTY_LEAF);
+    }
+
+    ~BufferPageTable() {
+        for (Leaf* const leaf : root) {
+            if (leaf != &EMPTY_LEAF) {
+                delete leaf;
+            }
+        }
+    }
+
+    SUYU_NON_COPYABLE(BufferPageTable);
+    SUYU_NON_MOVEABLE(BufferPageTable);
+
+    /// Returns the buffer in page, or an invalid id if there is none.
+    [[nodiscard]] Common::SlotId operator[](u64 page) const noexcept {
+        return (*root[page >> LEAF_BITS])[page & LEAF_MASK];
+    }
+
+    /// Sets the buffer in page, an invalid id clears it.
+    void Set(u64 page, Common::SlotId id) {
+        const u64 leaf_index = page >> LEAF_BITS;
+        Leaf* leaf = root[leaf_index];
+        const bool was_used = static_cast<bool>((*leaf)[page & LEAF_MASK]);
+        const bool is_used = static_cast<bool>(id);
+        if (!was_used && !is_used) {
+            return;
+        }
+        if (leaf == &EMPTY_LEAF) {
+            leaf = new Leaf(EMPTY_LEAF);
+            root[leaf_index] = leaf;
+            ++num_committed_leaves;
+        }
+        (*leaf)[page & LEAF_MASK] = id;
+        if (was_used == is_used) {
+            return;
+        }
+        if (is_used) {
+            ++num_used_pages[leaf_index];
+            return;
+        }
+        if (--num_used_pages[leaf_index] == 0) {
+            delete leaf;
+            root[leaf_index] = &EMPTY_LEAF;
+            --num_committed_leaves;
+        }
+    }
+
+    /// Returns the number of leaves currently committed.
+    [[nodiscard]] u64 NumCommittedLeaves() const noexcept {
+        return num_committed_leaves;
+    }
+
+    /// Returns the host memory used by the table, in bytes.
+    [[nodiscard]] u64 MemoryUsage() const noexcept {
+        return sizeof(*this) + num_committed_leaves * sizeof(Leaf);
+    }
+
+private:
+    // Shared by all uncommitted leaves, never written.
+    static inline Leaf EMPTY_LEAF{};
+
+    std::array<Leaf*, NUM_LEAVES> root;
+    std::array<u32, NUM_LEAVES> num_used_pages{};
+    u64 num_committed_leaves = 0;
+};
+
+} // namespace VideoCommon
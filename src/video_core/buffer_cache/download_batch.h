@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+#include "common/common_types.h"
+#include "video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+struct DownloadStats {
+    u64 bytes = 0;   ///< Bytes copied from the GPU
+    u64 copies = 0;  ///< Copy regions recorded
+    u64 batches = 0; ///< Copy commands recorded, one per source buffer and commit
+};
+
+/**
+ * Merges the overlapping and adjacent downloads of each buffer, then lays the result out in a
+ * staging buffer grouped by buffer, so every buffer can be downloaded with a single copy command.
+ *
+ * @param downloads Pairs of copies and the id of their source buffer, src_offset being relative to
+ *                  the buffer. Sorted by buffer and offset on return.
+ * @returns         The staging buffer size needed by the downloads.
+ */
+template <typename Container>
+u64 CoalesceDownloads(Container& downloads) {
+    // Align up to avoid cache conflicts
+    static constexpr u64 ALIGN = 64;
+
+    std::ranges::sort(downloads, [](const auto& lhs, const auto& rhs) {
+        return std::tie(lhs.second, lhs.first.src_offset) <
+               std::tie(rhs.second, rhs.first.src_offset);
+    });
+    auto last = downloads.begin();
+    for (auto it = downloads.begin(); it != downloads.end(); ++it) {
+        if (it != downloads.begin() && it->second == last->second &&
+            it->first.src_offset <= last->first.src_offset + last->first.size) {
+            const u64 end = std::max<u64>(last->first.src_offset + last->first.size,
+                                          it->first.src_offset + it->first.size);
+            last->first.size = end - last->first.src_offset;
+            continue;
+        }
+        if (it != downloads.begin()) {
+            ++last;
+        }
+        *last = *it;
+    }
+    if (!downloads.empty()) {
+        downloads.erase(std::next(last), downloads.end());
+    }
+
+    u64 total_size_bytes = 0;
+    for (auto& [copy, id] : downloads) {
+        copy.dst_offset = total_size_bytes;
+        total_size_bytes += (copy.size + ALIGN - 1) & ~(ALIGN - 1);
+    }
+    return total_size_bytes;
+}
+
+} // namespace VideoCommon
@@ -1,6 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <utility>
+
+#if defined(_MSC_VER) && defined(ARCHITECTURE_x86_64)
+#include <intrin.h>
+#endif
+
 #include "common/cityhash.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
@@ -16,6 +23,20 @@ namespace Tegra {
 constexpr u32 MacroRegistersStart = 0xE00;
 constexpr u32 ComputeInline = 0x6D;
 
+namespace {
+/// Number of bytes of an upcoming command list warmed up in the host cache
+constexpr std::size_t PrefetchBytes = 512;
+constexpr std::size_t CacheLineSize = 64;
+
+void PrefetchHostMemory(const void* pointer) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(pointer);
+#elif defined(_MSC_VER) && defined(ARCHITECTURE_x86_64)
+    _mm_prefetch(static_cast<const char*>(pointer), _MM_HINT_T0);
+#endif
+}
+} // Anonymous namespace
+
 DmaPusher::DmaPusher(Core::System& system_, GPU& gpu_, MemoryManager& memory_manager_,
                      Control::ChannelState& channel_state_)
     : gpu{gpu_}, system{system_}, memory_manager{memory_manager_}, puller{gpu_, memory_manager_,
@@ -29,6 +50,7 @@ void DmaPusher::DispatchCalls() {
     MICROPROFILE_SCOPE(DispatchCalls);
 
     dma_pushbuffer_subindex = 0;
+    ResetPrefetch();
 
     dma_state.is_last_call = true;
 
@@ -55,6 +77,7 @@ bool DmaPusher::Step() {
             // We ignore it and assume its size is 0.
             dma_pushbuffer.pop();
             dma_pushbuffer_subindex = 0;
+            ResetPrefetch();
             return true;
         });
 
@@ -63,6 +86,8 @@ bool DmaPusher::Step() {
         ProcessCommands(command_list.prefetch_command_list);
         dma_pushbuffer.pop();
     } else {
+        // Warm up the host cache for the upcoming entries
+        PrefetchCommandLists(command_list);
         const CommandListHeader command_list_header{
             command_list.command_lists[dma_pushbuffer_subindex++]};
         dma_state.dma_get = command_list_header.addr;
@@ -71,6 +96,7 @@ bool DmaPusher::Step() {
             // We've gone through the current list, remove it from the queue
             dma_pushbuffer.pop();
             dma_pushbuffer_subindex = 0;
+            ResetPrefetch();
         }
 
         if (command_list_header.size == 0) {
@@ -116,6 +142,32 @@ bool DmaPusher::Step() {
     return true;
 }
 
+void DmaPusher::PrefetchCommandLists(const CommandList& command_list) {
+    const std::size_t end =
+        std::min(dma_pushbuffer_subindex + prefetch_depth, command_list.command_lists.size());
+    for (; prefetch_subindex < end; ++prefetch_subindex) {
+        const CommandListHeader header{command_list.command_lists[prefetch_subindex]};
+        const std::size_t size_bytes = header.size * sizeof(u32);
+        if (size_bytes == 0) {
+            continue;
+        }
+        // Only used as a prefetch hint, never dereferenced. The entry is resolved again when it
+        // runs, as the GPU mapping can change in between.
+        const u8* const host_ptr = std::as_const(memory_manager).GetSpan(header.addr, size_bytes);
+        if (!host_ptr) {
+            continue;
+        }
+        const std::size_t prefetch_size = std::min(size_bytes, PrefetchBytes);
+        for (std::size_t offset = 0; offset < prefetch_size; offset += CacheLineSize) {
+            PrefetchHostMemory(host_ptr + offset);
+        }
+    }
+}
+
+void DmaPusher::ResetPrefetch() {
+    prefetch_subindex = 0;
+}
+
 void DmaPusher::ProcessCommands(std::span<const CommandHeader> commands) {
     for (std::size_t index = 0; index < commands.size();) {
         const CommandHeader& command_header = commands[index];
@@ -149,12 +149,19 @@ private:
     void CallMethod(u32 argument) const;
     void CallMultiMethod(const u32* base_start, u32 num_methods) const;
 
+    /// Warms up the host cache for the next entries of a command list ahead of execution
+    void PrefetchCommandLists(const CommandList& command_list);
+    void ResetPrefetch();
+
     Common::ScratchBuffer<CommandHeader>
         command_headers; ///< Buffer for list of commands fetched at once
 
     std::queue<CommandList> dma_pushbuffer; ///< Queue of command lists to be processed
     std::size_t dma_pushbuffer_subindex{};  ///< Index within a command list within the pushbuffer
 
+    static constexpr std::size_t prefetch_depth = 8; ///< Entries warmed up ahead of execution
+    std::size_t prefetch_subindex{}; ///< Index of the next command list entry to warm up
+
     struct DmaState {
         u32 method;            ///< Current method
         u32 subchannel;        ///< Current subchannel
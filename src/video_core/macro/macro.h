@@ -109,11 +109,25 @@ public:
     virtual void Execute(const std::vector<u32>& parameters, u32 method) = 0;
 };
 
+/// Receives the methods sent by macros in place of Maxwell3D, used to test the macro engines.
+class MacroMethodSink {
+public:
+    virtual ~MacroMethodSink() = default;
+
+    virtual void Send(u32 method, u32 argument) = 0;
+};
+
 class MacroEngine {
 public:
     explicit MacroEngine(Engines::Maxwell3D& maxwell3d);
     virtual ~MacroEngine();
 
+    /// Sends the methods of the macros compiled from now on to sink instead of Maxwell3D. Engines
+    /// pick the target when compiling, macros compiled without a sink don't check for one.
+    void SetMethodSink(MacroMethodSink* sink) {
+        method_sink = sink;
+    }
+
     // Store the uploaded macro code to compile them when they're called.
     void AddCode(u32 method, u32 data);
 
@@ -126,6 +140,8 @@ public:
 protected:
     virtual std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) = 0;
 
+    MacroMethodSink* method_sink{};
+
 private:
     struct CacheInfo {
         std::unique_ptr<CachedMacro> lle_program{};
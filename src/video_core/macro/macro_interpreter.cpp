@@ -14,10 +14,14 @@ MICROPROFILE_DEFINE(MacroInterp, "GPU", "Execute macro interpreter", MP_RGB(128,
 
 namespace Tegra {
 namespace {
+/// Interprets a macro, has_method_sink selects whether its methods are sent to a MacroMethodSink
+/// instead of Maxwell3D.
+template <bool has_method_sink>
 class MacroInterpreterImpl final : public CachedMacro {
 public:
-    explicit MacroInterpreterImpl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_)
-        : maxwell3d{maxwell3d_}, code{code_} {}
+    explicit MacroInterpreterImpl(Engines::Maxwell3D& maxwell3d_, MacroMethodSink* method_sink_,
+                                  const std::vector<u32>& code_)
+        : maxwell3d{maxwell3d_}, method_sink{method_sink_}, code{code_} {}
 
     void Execute(const std::vector<u32>& params, u32 method) override;
 
@@ -66,6 +70,7 @@ private:
     u32 FetchParameter();
 
     Engines::Maxwell3D& maxwell3d;
+    MacroMethodSink* method_sink;
 
     /// Current program counter
     u32 pc{};
@@ -89,7 +94,8 @@ private:
     const std::vector<u32>& code;
 };
 
-void MacroInterpreterImpl::Execute(const std::vector<u32>& params, u32 method) {
+template <bool has_method_sink>
+void MacroInterpreterImpl<has_method_sink>::Execute(const std::vector<u32>& params, u32 method) {
     MICROPROFILE_SCOPE(MacroInterp);
     Reset();
 
@@ -112,7 +118,8 @@ void MacroInterpreterImpl::Execute(const std::vector<u32>& params, u32 method) {
     ASSERT(next_parameter_index == num_parameters);
 }
 
-void MacroInterpreterImpl::Reset() {
+template <bool has_method_sink>
+void MacroInterpreterImpl<has_method_sink>::Reset() {
     registers = {};
     pc = 0;
     delayed_pc = {};
@@ -124,7 +131,8 @@ void MacroInterpreterImpl::Reset() {
     carry_flag = false;
 }
 
-bool MacroInterpreterImpl::Step(bool is_delay_slot) {
+template <bool has_method_sink>
+bool MacroInterpreterImpl<has_method_sink>::Step(bool is_delay_slot) {
     u32 base_address = pc;
 
     Macro::Opcode opcode = GetOpcode();
@@ -215,7 +223,9 @@ bool MacroInterpreterImpl::Step(bool is_delay_slot) {
     return true;
 }
 
-u32 MacroInterpreterImpl::GetALUResult(Macro::ALUOperation operation, u32 src_a, u32 src_b) {
+template <bool has_method_sink>
+u32 MacroInterpreterImpl<has_method_sink>::GetALUResult(Macro::ALUOperation operation, u32 src_a,
+                                                        u32 src_b) {
     switch (operation) {
     case Macro::ALUOperation::Add: {
         const u64 result{static_cast<u64>(src_a) + src_b};
@@ -254,7 +264,9 @@ u32 MacroInterpreterImpl::GetALUResult(Macro::ALUOperation operation, u32 src_a,
     }
 }
 
-void MacroInterpreterImpl::ProcessResult(Macro::ResultOperation operation, u32 reg, u32 result) {
+template <bool has_method_sink>
+void MacroInterpreterImpl<has_method_sink>::ProcessResult(Macro::ResultOperation operation, u32 reg,
+                                                          u32 result) {
     switch (operation) {
     case Macro::ResultOperation::IgnoreAndFetch:
         // Fetch parameter and ignore result.
@@ -302,7 +314,9 @@ void MacroInterpreterImpl::ProcessResult(Macro::ResultOperation operation, u32 r
     }
 }
 
-bool MacroInterpreterImpl::EvaluateBranchCondition(Macro::BranchCondition cond, u32 value) const {
+template <bool has_method_sink>
+bool MacroInterpreterImpl<has_method_sink>::EvaluateBranchCondition(Macro::BranchCondition cond,
+                                                                    u32 value) const {
     switch (cond) {
     case Macro::BranchCondition::Zero:
         return value == 0;
@@ -312,17 +326,20 @@ bool MacroInterpreterImpl::EvaluateBranchCondition(Macro::BranchCondition cond,
     UNREACHABLE();
 }
 
-Macro::Opcode MacroInterpreterImpl::GetOpcode() const {
+template <bool has_method_sink>
+Macro::Opcode MacroInterpreterImpl<has_method_sink>::GetOpcode() const {
     ASSERT((pc % sizeof(u32)) == 0);
     ASSERT(pc < code.size() * sizeof(u32));
     return {code[pc / sizeof(u32)]};
 }
 
-u32 MacroInterpreterImpl::GetRegister(u32 register_id) const {
+template <bool has_method_sink>
+u32 MacroInterpreterImpl<has_method_sink>::GetRegister(u32 register_id) const {
     return registers.at(register_id);
 }
 
-void MacroInterpreterImpl::SetRegister(u32 register_id, u32 value) {
+template <bool has_method_sink>
+void MacroInterpreterImpl<has_method_sink>::SetRegister(u32 register_id, u32 value) {
     // Register 0 is hardwired as the zero register.
     // Ensure no writes to it actually occur.
     if (register_id == 0) {
@@ -332,22 +349,30 @@ void MacroInterpreterImpl::SetRegister(u32 register_id, u32 value) {
     registers.at(register_id) = value;
 }
 
-void MacroInterpreterImpl::SetMethodAddress(u32 address) {
+template <bool has_method_sink>
+void MacroInterpreterImpl<has_method_sink>::SetMethodAddress(u32 address) {
     method_address.raw = address;
 }
 
-void MacroInterpreterImpl::Send(u32 value) {
-    maxwell3d.CallMethod(method_address.address, value, true);
+template <bool has_method_sink>
+void MacroInterpreterImpl<has_method_sink>::Send(u32 value) {
+    if constexpr (has_method_sink) {
+        method_sink->Send(method_address.address, value);
+    } else {
+        maxwell3d.CallMethod(method_address.address, value, true);
+    }
     // Increment the method address by the method increment.
     method_address.address.Assign(method_address.address.Value() +
                                   method_address.increment.Value());
 }
 
-u32 MacroInterpreterImpl::Read(u32 method) const {
+template <bool has_method_sink>
+u32 MacroInterpreterImpl<has_method_sink>::Read(u32 method) const {
     return maxwell3d.GetRegisterValue(method);
 }
 
-u32 MacroInterpreterImpl::FetchParameter() {
+template <bool has_method_sink>
+u32 MacroInterpreterImpl<has_method_sink>::FetchParameter() {
     ASSERT(next_parameter_index < num_parameters);
     return parameters[next_parameter_index++];
 }
@@ -357,7 +382,10 @@ MacroInterpreter::MacroInterpreter(Engines::Maxwell3D& maxwell3d_)
     : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
 
 std::unique_ptr<CachedMacro> MacroInterpreter::Compile(const std::vector<u32>& code) {
-    return std::make_unique<MacroInterpreterImpl>(maxwell3d, code);
+    if (method_sink) {
+        return std::make_unique<MacroInterpreterImpl<true>>(maxwell3d, method_sink, code);
+    }
+    return std::make_unique<MacroInterpreterImpl<false>>(maxwell3d, nullptr, code);
 }
 
 } // namespace Tegra
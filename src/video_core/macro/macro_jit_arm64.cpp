@@ -0,0 +1,514 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstddef>
+#include <vector>
+
+#include <oaknut/code_block.hpp>
+#include <oaknut/oaknut.hpp>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro_jit_arm64.h"
+
+MICROPROFILE_DEFINE(MacroJitCompile, "GPU", "Compile macro JIT", MP_RGB(173, 255, 47));
+MICROPROFILE_DEFINE(MacroJitExecute, "GPU", "Execute macro JIT", MP_RGB(255, 255, 0));
+
+namespace Tegra {
+namespace {
+using namespace oaknut::util;
+
+// Macro registers 1 to 7 are kept in W19 to W25 for the whole program, register 0 is WZR.
+constexpr int FIRST_MACRO_REGISTER = 18;
+constexpr oaknut::XReg PARAMETERS = X26;
+constexpr oaknut::WReg RESULT = W27;
+constexpr oaknut::XReg RESULT_64 = X27;
+constexpr oaknut::WReg METHOD_ADDRESS = W28;
+
+// Stack frame: X29, X30 and the callee saved X19 to X28, followed by the spilled program state.
+constexpr u32 FRAME_SIZE = 128;
+constexpr u32 MAXWELL3D_OFFSET = 96;
+constexpr u32 PARAMETERS_END_OFFSET = 104;
+constexpr u32 CARRY_OFFSET = 112;
+
+// Worst case size of a single macro instruction, including a copy emitted as a delay slot.
+constexpr size_t MAX_INSTRUCTION_SIZE = 0x200;
+constexpr size_t BASE_CODE_SIZE = 0x1000;
+
+oaknut::WReg MacroRegister(u32 index) {
+    if (index == 0) {
+        // Register 0 is always zero
+        return WZR;
+    }
+    return oaknut::WReg{FIRST_MACRO_REGISTER + static_cast<int>(index)};
+}
+
+void Send(Engines::Maxwell3D* maxwell3d, u32 method_address, u32 value) {
+    const Macro::MethodAddress address{method_address};
+    maxwell3d->CallMethod(address.address, value, true);
+}
+
+void SendToSink(MacroMethodSink* method_sink, u32 method_address, u32 value) {
+    const Macro::MethodAddress address{method_address};
+    method_sink->Send(address.address, value);
+}
+
+void WarnInvalidParameter(uintptr_t parameter, uintptr_t max_parameter) {
+    LOG_CRITICAL(HW_GPU,
+                 "Macro JIT: invalid parameter access 0x{:x} (0x{:x} is the last parameter)",
+                 parameter, max_parameter - sizeof(u32));
+}
+
+class MacroJITArm64Impl final : public CachedMacro {
+public:
+    explicit MacroJITArm64Impl(Engines::Maxwell3D& maxwell3d_, MacroMethodSink* method_sink_,
+                               const std::vector<u32>& code_)
+        : code_block{BASE_CODE_SIZE + code_.size() * MAX_INSTRUCTION_SIZE},
+          c{code_block.ptr()}, labels(code_.size()), code{code_}, maxwell3d{maxwell3d_},
+          method_sink{method_sink_} {
+        Compile();
+    }
+
+    void Execute(const std::vector<u32>& parameters, u32 method) override;
+
+private:
+    using ProgramType = void (*)(Engines::Maxwell3D*, const u32*, const u32*);
+
+    void Compile();
+    void Compile_Instruction(u32 index, bool is_delay_slot);
+
+    void Compile_ALU(Macro::Opcode opcode);
+    void Compile_AddImmediate(Macro::Opcode opcode);
+    void Compile_ExtractInsert(Macro::Opcode opcode);
+    void Compile_ExtractShiftLeftImmediate(Macro::Opcode opcode);
+    void Compile_ExtractShiftLeftRegister(Macro::Opcode opcode);
+    void Compile_Read(Macro::Opcode opcode);
+    void Compile_Branch(Macro::Opcode opcode, u32 index);
+
+    void Compile_AddConstant(oaknut::WReg dst, u32 src_index, s32 immediate);
+    void Compile_ExtractBitfield(oaknut::WReg dst, oaknut::WReg src, u32 mask);
+    void Compile_LoadCarry();
+    void Compile_StoreCarry();
+    void Compile_FetchParameter(oaknut::WReg dst);
+    void Compile_Send(oaknut::WReg value);
+    void Compile_ProcessResult(Macro::ResultOperation operation, u32 reg);
+
+    template <typename Function>
+    void Compile_Call(Function* function);
+
+    oaknut::Label& BranchTarget(s64 target);
+
+    oaknut::CodeBlock code_block;
+    oaknut::CodeGenerator c;
+
+    std::vector<oaknut::Label> labels;
+    oaknut::Label end_of_code;
+    bool can_skip_carry{};
+    ProgramType program{};
+
+    const std::vector<u32>& code;
+    Engines::Maxwell3D& maxwell3d;
+    MacroMethodSink* method_sink;
+};
+
+void MacroJITArm64Impl::Execute(const std::vector<u32>& parameters, u32 method) {
+    MICROPROFILE_SCOPE(MacroJitExecute);
+    ASSERT_OR_EXECUTE(program != nullptr, { return; });
+    program(&maxwell3d, parameters.data(), parameters.data() + parameters.size());
+}
+
+void MacroJITArm64Impl::Compile() {
+    MICROPROFILE_SCOPE(MacroJitCompile);
+
+    // Carry handling is only emitted when an instruction consumes the carry flag
+    can_skip_carry = true;
+    for (const u32 raw_op : code) {
+        const Macro::Opcode op{raw_op};
+        if (op.operation == Macro::Operation::ALU &&
+            (op.alu_operation == Macro::ALUOperation::AddWithCarry ||
+             op.alu_operation == Macro::ALUOperation::SubtractWithBorrow)) {
+            can_skip_carry = false;
+        }
+    }
+
+    code_block.unprotect();
+    program = reinterpret_cast<ProgramType>(code_block.ptr());
+
+    c.STP(X29, X30, SP, PRE_INDEXED, -static_cast<int>(FRAME_SIZE));
+    c.STP(X19, X20, SP, 16);
+    c.STP(X21, X22, SP, 32);
+    c.STP(X23, X24, SP, 48);
+    c.STP(X25, X26, SP, 64);
+    c.STP(X27, X28, SP, 80);
+    c.STR(X0, SP, MAXWELL3D_OFFSET);
+    c.STR(X2, SP, PARAMETERS_END_OFFSET);
+    c.STR(WZR, SP, CARRY_OFFSET);
+    c.MOV(PARAMETERS, X1);
+    c.MOV(METHOD_ADDRESS, WZR);
+    for (u32 reg = 1; reg < Macro::NUM_MACRO_REGISTERS; ++reg) {
+        c.MOV(MacroRegister(reg), WZR);
+    }
+    // The first parameter is always loaded into register 1
+    Compile_FetchParameter(MacroRegister(1));
+
+    for (u32 index = 0; index < static_cast<u32>(code.size()); ++index) {
+        c.l(labels[index]);
+        Compile_Instruction(index, false);
+    }
+
+    c.l(end_of_code);
+    c.LDP(X27, X28, SP, 80);
+    c.LDP(X25, X26, SP, 64);
+    c.LDP(X23, X24, SP, 48);
+    c.LDP(X21, X22, SP, 32);
+    c.LDP(X19, X20, SP, 16);
+    c.LDP(X29, X30, SP, POST_INDEXED, static_cast<int>(FRAME_SIZE));
+    c.RET();
+
+    code_block.protect();
+    code_block.invalidate_all();
+}
+
+void MacroJITArm64Impl::Compile_Instruction(u32 index, bool is_delay_slot) {
+    const Macro::Opcode opcode{code[index]};
+    switch (opcode.operation) {
+    case Macro::Operation::ALU:
+        Compile_ALU(opcode);
+        break;
+    case Macro::Operation::AddImmediate:
+        Compile_AddImmediate(opcode);
+        break;
+    case Macro::Operation::ExtractInsert:
+        Compile_ExtractInsert(opcode);
+        break;
+    case Macro::Operation::ExtractShiftLeftImmediate:
+        Compile_ExtractShiftLeftImmediate(opcode);
+        break;
+    case Macro::Operation::ExtractShiftLeftRegister:
+        Compile_ExtractShiftLeftRegister(opcode);
+        break;
+    case Macro::Operation::Read:
+        Compile_Read(opcode);
+        break;
+    case Macro::Operation::Branch:
+        if (is_delay_slot) {
+            LOG_ERROR(HW_GPU, "Macro JIT: branch in a delay slot at 0x{:x}", index);
+            return;
+        }
+        Compile_Branch(opcode, index);
+        break;
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented opcode {}", opcode.operation.Value());
+        break;
+    }
+
+    // An exit only takes effect outside of delay slots, and it has a delay slot of its own
+    if (opcode.is_exit && !is_delay_slot) {
+        if (index + 1 < code.size()) {
+            Compile_Instruction(index + 1, true);
+        }
+        c.B(end_of_code);
+    }
+}
+
+void MacroJITArm64Impl::Compile_ALU(Macro::Opcode opcode) {
+    const oaknut::WReg src_a = MacroRegister(opcode.src_a);
+    const oaknut::WReg src_b = MacroRegister(opcode.src_b);
+
+    switch (opcode.alu_operation) {
+    case Macro::ALUOperation::Add:
+        if (can_skip_carry) {
+            c.ADD(RESULT, src_a, src_b);
+        } else {
+            c.ADDS(RESULT, src_a, src_b);
+            Compile_StoreCarry();
+        }
+        break;
+    case Macro::ALUOperation::AddWithCarry:
+        Compile_LoadCarry();
+        c.ADCS(RESULT, src_a, src_b);
+        Compile_StoreCarry();
+        break;
+    case Macro::ALUOperation::Subtract:
+        // The macro carry flag is set when there is no borrow, which matches the host flag
+        if (can_skip_carry) {
+            c.SUB(RESULT, src_a, src_b);
+        } else {
+            c.SUBS(RESULT, src_a, src_b);
+            Compile_StoreCarry();
+        }
+        break;
+    case Macro::ALUOperation::SubtractWithBorrow:
+        Compile_LoadCarry();
+        c.SBCS(RESULT, src_a, src_b);
+        Compile_StoreCarry();
+        break;
+    case Macro::ALUOperation::Xor:
+        c.EOR(RESULT, src_a, src_b);
+        break;
+    case Macro::ALUOperation::Or:
+        c.ORR(RESULT, src_a, src_b);
+        break;
+    case Macro::ALUOperation::And:
+        c.AND(RESULT, src_a, src_b);
+        break;
+    case Macro::ALUOperation::AndNot:
+        c.BIC(RESULT, src_a, src_b);
+        break;
+    case Macro::ALUOperation::Nand:
+        c.AND(RESULT, src_a, src_b);
+        c.MVN(RESULT, RESULT);
+        break;
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented ALU operation {}", opcode.alu_operation.Value());
+        break;
+    }
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITArm64Impl::Compile_AddImmediate(Macro::Opcode opcode) {
+    // Games tend to use this as a NOP placeholder, there is nothing to emit for it
+    if (opcode.result_operation == Macro::ResultOperation::Move && opcode.dst == 0) {
+        return;
+    }
+    Compile_AddConstant(RESULT, opcode.src_a, opcode.immediate);
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITArm64Impl::Compile_ExtractInsert(Macro::Opcode opcode) {
+    const u32 mask = opcode.GetBitfieldMask();
+    const u32 src_bit = opcode.bf_src_bit;
+    const u32 dst_bit = opcode.bf_dst_bit;
+
+    c.LSR(W9, MacroRegister(opcode.src_b), src_bit);
+    Compile_ExtractBitfield(W9, W9, mask);
+    c.LSL(W9, W9, dst_bit);
+    c.MOV(W10, ~(mask << dst_bit));
+    c.AND(RESULT, MacroRegister(opcode.src_a), W10);
+    c.ORR(RESULT, RESULT, W9);
+
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITArm64Impl::Compile_ExtractShiftLeftImmediate(Macro::Opcode opcode) {
+    const u32 dst_bit = opcode.bf_dst_bit;
+
+    c.LSR(W9, MacroRegister(opcode.src_b), MacroRegister(opcode.src_a));
+    Compile_ExtractBitfield(W9, W9, opcode.GetBitfieldMask());
+    c.LSL(RESULT, W9, dst_bit);
+
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITArm64Impl::Compile_ExtractShiftLeftRegister(Macro::Opcode opcode) {
+    const u32 src_bit = opcode.bf_src_bit;
+
+    c.LSR(W9, MacroRegister(opcode.src_b), src_bit);
+    Compile_ExtractBitfield(W9, W9, opcode.GetBitfieldMask());
+    c.LSL(RESULT, W9, MacroRegister(opcode.src_a));
+
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITArm64Impl::Compile_Read(Macro::Opcode opcode) {
+    Compile_AddConstant(RESULT, opcode.src_a, opcode.immediate);
+
+    // Equivalent to Engines::Maxwell3D::GetRegisterValue, out of range reads return zero
+    constexpr size_t reg_array_offset =
+        offsetof(Engines::Maxwell3D, regs) + offsetof(Engines::Maxwell3D::Regs, reg_array);
+    oaknut::Label in_range;
+    oaknut::Label done;
+    c.CMP(RESULT, static_cast<u32>(Engines::Maxwell3D::Regs::NUM_REGS));
+    c.B(LO, in_range);
+    c.MOV(RESULT, WZR);
+    c.B(done);
+    c.l(in_range);
+    c.LDR(X9, SP, MAXWELL3D_OFFSET);
+    c.MOV(X10, static_cast<u64>(reg_array_offset));
+    c.ADD(X9, X9, X10);
+    c.LSL(X10, RESULT_64, 2);
+    c.ADD(X9, X9, X10);
+    c.LDR(RESULT, X9);
+    c.l(done);
+
+    Compile_ProcessResult(opcode.result_operation, opcode.dst);
+}
+
+void MacroJITArm64Impl::Compile_Branch(Macro::Opcode opcode, u32 index) {
+    oaknut::Label& target = BranchTarget(static_cast<s64>(index) + opcode.immediate);
+
+    oaknut::Label not_taken;
+    if (opcode.src_a == 0) {
+        // Branches on the zero register are either always or never taken
+        if (opcode.branch_condition != Macro::BranchCondition::Zero) {
+            return;
+        }
+    } else {
+        const oaknut::WReg value = MacroRegister(opcode.src_a);
+        switch (opcode.branch_condition) {
+        case Macro::BranchCondition::Zero:
+            c.CBNZ(value, not_taken);
+            break;
+        case Macro::BranchCondition::NotZero:
+            c.CBZ(value, not_taken);
+            break;
+        }
+    }
+
+    // Taken branches without the annul bit execute the next instruction before jumping
+    if (!opcode.branch_annul && index + 1 < code.size()) {
+        Compile_Instruction(index + 1, true);
+    }
+    c.B(target);
+    c.l(not_taken);
+}
+
+void MacroJITArm64Impl::Compile_AddConstant(oaknut::WReg dst, u32 src_index, s32 immediate) {
+    if (src_index == 0) {
+        c.MOV(dst, static_cast<u32>(immediate));
+        return;
+    }
+    // Immediate forms treat register 31 as SP, the zero register was handled above
+    const oaknut::WReg src = MacroRegister(src_index);
+    if (immediate == 0) {
+        c.MOV(dst, src);
+    } else if (immediate > 0 && immediate < 0x1000) {
+        c.ADD(dst, src, static_cast<u32>(immediate));
+    } else if (immediate < 0 && immediate > -0x1000) {
+        c.SUB(dst, src, static_cast<u32>(-immediate));
+    } else {
+        c.MOV(W9, static_cast<u32>(immediate));
+        c.ADD(dst, src, W9);
+    }
+}
+
+void MacroJITArm64Impl::Compile_ExtractBitfield(oaknut::WReg dst, oaknut::WReg src, u32 mask) {
+    c.MOV(W10, mask);
+    c.AND(dst, src, W10);
+}
+
+void MacroJITArm64Impl::Compile_LoadCarry() {
+    // Comparing the stored flag against one sets the host carry flag to its value
+    c.LDR(W9, SP, CARRY_OFFSET);
+    c.CMP(W9, 1);
+}
+
+void MacroJITArm64Impl::Compile_StoreCarry() {
+    c.CSET(W9, CS);
+    c.STR(W9, SP, CARRY_OFFSET);
+}
+
+void MacroJITArm64Impl::Compile_FetchParameter(oaknut::WReg dst) {
+    oaknut::Label invalid;
+    oaknut::Label done;
+    c.LDR(X9, SP, PARAMETERS_END_OFFSET);
+    c.CMP(PARAMETERS, X9);
+    c.B(HS, invalid);
+    c.LDR(dst, PARAMETERS, POST_INDEXED, sizeof(u32));
+    c.B(done);
+    c.l(invalid);
+    c.MOV(X0, PARAMETERS);
+    c.MOV(X1, X9);
+    Compile_Call(&WarnInvalidParameter);
+    c.MOV(dst, WZR);
+    c.l(done);
+}
+
+void MacroJITArm64Impl::Compile_Send(oaknut::WReg value) {
+    c.MOV(W2, value);
+    c.MOV(W1, METHOD_ADDRESS);
+    if (method_sink) {
+        c.MOV(X0, reinterpret_cast<u64>(method_sink));
+        Compile_Call(&SendToSink);
+    } else {
+        c.LDR(X0, SP, MAXWELL3D_OFFSET);
+        Compile_Call(&Send);
+    }
+
+    // Advance the method address by its increment
+    c.UBFX(W9, METHOD_ADDRESS, 12, 6);
+    c.ADD(W9, METHOD_ADDRESS, W9);
+    c.BFI(METHOD_ADDRESS, W9, 0, 12);
+}
+
+void MacroJITArm64Impl::Compile_ProcessResult(Macro::ResultOperation operation, u32 reg) {
+    const oaknut::WReg dst = MacroRegister(reg);
+    const auto SetRegister = [&](oaknut::WReg value) {
+        // Register 0 is supposed to always return 0. NOP is implemented as a store to the zero
+        // register.
+        if (reg != 0) {
+            c.MOV(dst, value);
+        }
+    };
+    const auto SetMethodAddress = [&] { c.MOV(METHOD_ADDRESS, RESULT); };
+
+    switch (operation) {
+    case Macro::ResultOperation::IgnoreAndFetch:
+        Compile_FetchParameter(dst);
+        break;
+    case Macro::ResultOperation::Move:
+        SetRegister(RESULT);
+        break;
+    case Macro::ResultOperation::MoveAndSetMethod:
+        SetRegister(RESULT);
+        SetMethodAddress();
+        break;
+    case Macro::ResultOperation::FetchAndSend:
+        // Fetch parameter and send result.
+        Compile_FetchParameter(dst);
+        Compile_Send(RESULT);
+        break;
+    case Macro::ResultOperation::MoveAndSend:
+        // Move and send result.
+        SetRegister(RESULT);
+        Compile_Send(RESULT);
+        break;
+    case Macro::ResultOperation::FetchAndSetMethod:
+        // Fetch parameter and use result as Method Address.
+        Compile_FetchParameter(dst);
+        SetMethodAddress();
+        break;
+    case Macro::ResultOperation::MoveAndSetMethodFetchAndSend:
+        // Move result and use as Method Address, then fetch and send parameter.
+        SetRegister(RESULT);
+        SetMethodAddress();
+        Compile_FetchParameter(W8);
+        Compile_Send(W8);
+        break;
+    case Macro::ResultOperation::MoveAndSetMethodSend:
+        // Move result and use as Method Address, then send bits 12:17 of result.
+        SetRegister(RESULT);
+        SetMethodAddress();
+        c.UBFX(W8, RESULT, 12, 6);
+        Compile_Send(W8);
+        break;
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented macro operation {}", operation);
+        break;
+    }
+}
+
+template <typename Function>
+void MacroJITArm64Impl::Compile_Call(Function* function) {
+    c.MOV(X16, reinterpret_cast<u64>(function));
+    c.BLR(X16);
+}
+
+oaknut::Label& MacroJITArm64Impl::BranchTarget(s64 target) {
+    if (target < 0 || target >= static_cast<s64>(labels.size())) {
+        LOG_ERROR(HW_GPU, "Macro JIT: branch target 0x{:x} is out of bounds", target);
+        return end_of_code;
+    }
+    return labels[static_cast<size_t>(target)];
+}
+} // Anonymous namespace
+
+MacroJITArm64::MacroJITArm64(Engines::Maxwell3D& maxwell3d_)
+    : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
+
+std::unique_ptr<CachedMacro> MacroJITArm64::Compile(const std::vector<u32>& code) {
+    return std::make_unique<MacroJITArm64Impl>(maxwell3d, method_sink, code);
+}
+} // namespace Tegra
@@ -47,8 +47,10 @@ std::bitset<32> PersistentCallerSavedRegs() {
 
 class MacroJITx64Impl final : public Xbyak::CodeGenerator, public CachedMacro {
 public:
-    explicit MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_)
-        : CodeGenerator{MAX_CODE_SIZE}, code{code_}, maxwell3d{maxwell3d_} {
+    explicit MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, MacroMethodSink* method_sink_,
+                             const std::vector<u32>& code_)
+        : CodeGenerator{MAX_CODE_SIZE}, code{code_}, maxwell3d{maxwell3d_},
+          method_sink{method_sink_} {
         Compile();
     }
 
@@ -106,6 +108,7 @@ private:
 
     const std::vector<u32>& code;
     Engines::Maxwell3D& maxwell3d;
+    MacroMethodSink* method_sink;
 };
 
 void MacroJITx64Impl::Execute(const std::vector<u32>& parameters, u32 method) {
@@ -349,12 +352,24 @@ void Send(Engines::Maxwell3D* maxwell3d, Macro::MethodAddress method_address, u3
     maxwell3d->CallMethod(method_address.address, value, true);
 }
 
+void SendToSink(MacroMethodSink* method_sink, Macro::MethodAddress method_address, u32 value) {
+    method_sink->Send(method_address.address, value);
+}
+
 void MacroJITx64Impl::Compile_Send(Xbyak::Reg32 value) {
     Common::X64::ABI_PushRegistersAndAdjustStack(*this, PersistentCallerSavedRegs(), 0);
-    mov(Common::X64::ABI_PARAM1, qword[STATE]);
+    if (method_sink) {
+        mov(Common::X64::ABI_PARAM1, reinterpret_cast<u64>(method_sink));
+    } else {
+        mov(Common::X64::ABI_PARAM1, qword[STATE]);
+    }
     mov(Common::X64::ABI_PARAM2, METHOD_ADDRESS);
     mov(Common::X64::ABI_PARAM3, value);
-    Common::X64::CallFarFunction(*this, &Send);
+    if (method_sink) {
+        Common::X64::CallFarFunction(*this, &SendToSink);
+    } else {
+        Common::X64::CallFarFunction(*this, &Send);
+    }
     Common::X64::ABI_PopRegistersAndAdjustStack(*this, PersistentCallerSavedRegs(), 0);
 
     Xbyak::Label dont_process{};
@@ -666,6 +681,6 @@ MacroJITx64::MacroJITx64(Engines::Maxwell3D& maxwell3d_)
     : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
 
 std::unique_ptr<CachedMacro> MacroJITx64::Compile(const std::vector<u32>& code) {
-    return std::make_unique<MacroJITx64Impl>(maxwell3d, code);
+    return std::make_unique<MacroJITx64Impl>(maxwell3d, method_sink, code);
 }
 } // namespace Tegra
@@ -26,6 +26,7 @@ public:
     DAddr guest_address{};
     QueryFlagBits flags{};
     u64 value{};
+    u64 report_tick{}; ///< Number of async flushes committed when the guest reported the query
 
 protected:
     // Default constructor
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -129,7 +131,7 @@ struct QueryCacheBase<Traits>::QueryCacheBaseImpl {
     template <typename Func>
     void ForEachStreamerIn(u64 mask, Func&& func) {
         static constexpr bool RETURNS_BOOL =
-            std::is_same_v<std::invoke_result<Func, StreamerInterface*>, bool>;
+            std::is_same_v<std::invoke_result_t<Func, StreamerInterface*>, bool>;
         while (mask != 0) {
             size_t position = std::countr_zero(mask);
             mask &= ~(1ULL << position);
@@ -148,6 +150,23 @@ struct QueryCacheBase<Traits>::QueryCacheBaseImpl {
         ForEachStreamerIn(streamer_mask, func);
     }
 
+    /// Returns true when a CPU read of pending queries, the oldest one reported at
+    /// oldest_report_tick, can be served with their last resolved values.
+    bool TryDeferRead(u64 oldest_report_tick) {
+        const u64 latency = Settings::values.query_result_latency.GetValue();
+        const u64 age = flush_tick.load(std::memory_order_relaxed) - oldest_report_tick;
+        if (latency == 0 || age >= latency) {
+            return false;
+        }
+        // Guests that spin on a result may not submit more work until they see it.
+        if (consecutive_deferred_reads.fetch_add(1, std::memory_order_relaxed) >=
+            MAX_CONSECUTIVE_DEFERRED_READS) {
+            return false;
+        }
+        deferred_reads.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
     QueryBase* ObtainQuery(QueryCacheBase<Traits>::QueryLocation location) {
         size_t which_stream = location.stream_id.Value();
         auto* streamer = streamers[which_stream];
@@ -167,6 +186,13 @@ struct QueryCacheBase<Traits>::QueryCacheBaseImpl {
     std::mutex flush_guard;
     std::deque<u64> flushes_pending;
     std::vector<QueryCacheBase<Traits>::QueryLocation> pending_unregister;
+
+    static constexpr u32 MAX_CONSECUTIVE_DEFERRED_READS = 64;
+    std::atomic<u64> flush_tick{};
+    std::atomic<u32> consecutive_deferred_reads{};
+    std::atomic<u64> forced_syncs{};
+    std::atomic<u64> deferred_reads{};
+    std::atomic<u64> host_conditional_renders{};
 };
 
 template <typename Traits>
@@ -245,6 +271,7 @@ void QueryCacheBase<Traits>::CounterReport(GPUVAddr addr, QueryType counter_type
     DAddr cpu_addr = *cpu_addr_opt;
     const size_t new_query_id = streamer->WriteCounter(cpu_addr, has_timestamp, payload, subreport);
     auto* query = streamer->GetQuery(new_query_id);
+    query->report_tick = impl->flush_tick.load(std::memory_order_relaxed);
     if (is_fence) {
         query->flags |= QueryFlagBits::IsFence;
     }
@@ -417,6 +444,13 @@ bool QueryCacheBase<Traits>::AccelerateHostConditionalRendering() {
         };
     };
 
+    const auto count_accelerated = [this](bool accelerated) {
+        if (accelerated) {
+            impl->host_conditional_renders.fetch_add(1, std::memory_order_relaxed);
+        }
+        return accelerated;
+    };
+
     auto& regs = maxwell3d->regs;
     if (regs.render_enable_override != Maxwell::Regs::RenderEnable::Override::UseRenderEnable) {
         impl->runtime.EndHostConditionalRendering();
@@ -433,19 +467,20 @@ bool QueryCacheBase<Traits>::AccelerateHostConditionalRendering() {
         return false;
     case ComparisonMode::Conditional: {
         VideoCommon::LookupData object_1{gen_lookup(address)};
-        return impl->runtime.HostConditionalRenderingCompareValue(object_1, qc_dirty);
+        return count_accelerated(
+            impl->runtime.HostConditionalRenderingCompareValue(object_1, qc_dirty));
     }
     case ComparisonMode::IfEqual: {
         VideoCommon::LookupData object_1{gen_lookup(address)};
         VideoCommon::LookupData object_2{gen_lookup(address + 16)};
-        return impl->runtime.HostConditionalRenderingCompareValues(object_1, object_2, qc_dirty,
-                                                                   true);
+        return count_accelerated(impl->runtime.HostConditionalRenderingCompareValues(
+            object_1, object_2, qc_dirty, true));
     }
     case ComparisonMode::IfNotEqual: {
         VideoCommon::LookupData object_1{gen_lookup(address)};
         VideoCommon::LookupData object_2{gen_lookup(address + 16)};
-        return impl->runtime.HostConditionalRenderingCompareValues(object_1, object_2, qc_dirty,
-                                                                   false);
+        return count_accelerated(impl->runtime.HostConditionalRenderingCompareValues(
+            object_1, object_2, qc_dirty, false));
     }
     default:
         return false;
@@ -471,6 +506,10 @@ void QueryCacheBase<Traits>::CommitAsyncFlushes() {
     }
     std::function<void()> func([this] { UnregisterPending(); });
     impl->rasterizer.SyncOperation(std::move(func));
+
+    // Queries reported until now are on their way, reads of them can be deferred a bit longer.
+    impl->flush_tick.fetch_add(1, std::memory_order_relaxed);
+    impl->consecutive_deferred_reads.store(0, std::memory_order_relaxed);
     if (mask == 0) {
         return;
     }
@@ -489,6 +528,15 @@ void QueryCacheBase<Traits>::CommitAsyncFlushes() {
     }
 }
 
+template <typename Traits>
+QueryCacheStats QueryCacheBase<Traits>::GetStats() const {
+    return QueryCacheStats{
+        .forced_syncs = impl->forced_syncs.load(std::memory_order_relaxed),
+        .deferred_reads = impl->deferred_reads.load(std::memory_order_relaxed),
+        .host_conditional_renders = impl->host_conditional_renders.load(std::memory_order_relaxed),
+    };
+}
+
 template <typename Traits>
 bool QueryCacheBase<Traits>::HasUncommittedFlushes() const {
     bool result = false;
@@ -553,7 +601,8 @@ bool QueryCacheBase<Traits>::IsQueryDirty(QueryCacheBase<Traits>::QueryLocation
 }
 
 template <typename Traits>
-bool QueryCacheBase<Traits>::SemiFlushQueryDirty(QueryCacheBase<Traits>::QueryLocation location) {
+bool QueryCacheBase<Traits>::SemiFlushQueryDirty(QueryCacheBase<Traits>::QueryLocation location,
+                                                  u64& oldest_report_tick) {
     auto* query_base = impl->ObtainQuery(location);
     if (!query_base) {
         return false;
@@ -569,12 +618,24 @@ bool QueryCacheBase<Traits>::SemiFlushQueryDirty(QueryCacheBase<Traits>::QueryLo
         std::memcpy(ptr, &value_l, sizeof(value_l));
         return false;
     }
-    return True(query_base->flags & QueryFlagBits::IsHostManaged) &&
-           False(query_base->flags & QueryFlagBits::IsGuestSynced);
+    if (False(query_base->flags & QueryFlagBits::IsHostManaged) ||
+        True(query_base->flags & QueryFlagBits::IsGuestSynced)) {
+        return false;
+    }
+    oldest_report_tick = std::min(oldest_report_tick, query_base->report_tick);
+    return true;
+}
+
+template <typename Traits>
+bool QueryCacheBase<Traits>::TryDeferGuestHostSync(u64 oldest_report_tick) {
+    // Guest memory still holds the last results resolved at the flushed addresses.
+    return impl->TryDeferRead(oldest_report_tick);
 }
 
 template <typename Traits>
 void QueryCacheBase<Traits>::RequestGuestHostSync() {
+    impl->forced_syncs.fetch_add(1, std::memory_order_relaxed);
+    impl->consecutive_deferred_reads.store(0, std::memory_order_relaxed);
     impl->rasterizer.ReleaseFences();
 }
 
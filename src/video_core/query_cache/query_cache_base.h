@@ -4,6 +4,7 @@
 #pragma once
 
 #include <functional>
+#include <limits>
 #include <mutex>
 #include <optional>
 #include <span>
@@ -61,11 +62,13 @@ public:
 
     void FlushRegion(VAddr addr, std::size_t size) {
         bool result = false;
-        IterateCache<false>(addr, size, [this, &result](QueryLocation location) {
-            result |= SemiFlushQueryDirty(location);
-            return result;
-        });
-        if (result) {
+        u64 oldest_report_tick = std::numeric_limits<u64>::max();
+        // Every query is visited, the deferral depends on the oldest dirty one
+        IterateCache<false>(addr, size,
+                            [this, &result, &oldest_report_tick](QueryLocation location) {
+                                result |= SemiFlushQueryDirty(location, oldest_report_tick);
+                            });
+        if (result && !TryDeferGuestHostSync(oldest_report_tick)) {
             RequestGuestHostSync();
         }
     }
@@ -101,6 +104,8 @@ public:
 
     bool AccelerateHostConditionalRendering();
 
+    [[nodiscard]] QueryCacheStats GetStats() const;
+
     // Async downloads
     void CommitAsyncFlushes();
 
@@ -118,7 +123,7 @@ protected:
     template <bool remove_from_cache, typename Func>
     void IterateCache(VAddr addr, std::size_t size, Func&& func) {
         static constexpr bool RETURNS_BOOL =
-            std::is_same_v<std::invoke_result<Func, QueryLocation>, bool>;
+            std::is_same_v<std::invoke_result_t<Func, QueryLocation>, bool>;
         const u64 addr_begin = addr;
         const u64 addr_end = addr_begin + size;
 
@@ -161,7 +166,8 @@ protected:
 
     void InvalidateQuery(QueryLocation location);
     bool IsQueryDirty(QueryLocation location);
-    bool SemiFlushQueryDirty(QueryLocation location);
+    bool SemiFlushQueryDirty(QueryLocation location, u64& oldest_report_tick);
+    bool TryDeferGuestHostSync(u64 oldest_report_tick);
     void RequestGuestHostSync();
     void UnregisterPending();
 
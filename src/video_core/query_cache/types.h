@@ -58,6 +58,12 @@ enum class ComparisonMode : u32 {
     MaxComparisonMode,
 };
 
+struct QueryCacheStats {
+    u64 forced_syncs = 0;             ///< CPU reads that waited for pending query results
+    u64 deferred_reads = 0;           ///< CPU reads served with the last resolved results
+    u64 host_conditional_renders = 0; ///< Conditional renders evaluated on the GPU
+};
+
 // Reduction ops.
 enum class ReductionOp : u32 {
     RedAdd = 0,
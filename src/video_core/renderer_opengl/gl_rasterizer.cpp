@@ -152,7 +152,12 @@ void RasterizerOpenGL::SyncVertexInstances() {
 
 void RasterizerOpenGL::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
-    shader_cache.LoadDiskResources(title_id, stop_loading, callback);
+    if (Settings::values.use_disk_texture_cache.GetValue()) {
+        texture_cache.LoadDiskResources(title_id);
+    }
+    if (Settings::values.use_disk_shader_cache.GetValue()) {
+        shader_cache.LoadDiskResources(title_id, stop_loading, callback);
+    }
 }
 
 void RasterizerOpenGL::Clear(u32 layer_count) {
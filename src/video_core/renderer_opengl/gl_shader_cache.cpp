@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <atomic>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <mutex>
@@ -47,8 +48,6 @@ using VideoCommon::ComputeEnvironment;
 using VideoCommon::FileEnvironment;
 using VideoCommon::GenericEnvironment;
 using VideoCommon::GraphicsEnvironment;
-using VideoCommon::LoadPipelines;
-using VideoCommon::SerializePipeline;
 using Context = ShaderContext::Context;
 
 constexpr u32 CACHE_VERSION = 10;
@@ -266,7 +265,7 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         LOG_ERROR(Common_Filesystem, "Failed to create shader cache directories");
         return;
     }
-    shader_cache_filename = base_dir / "opengl.bin";
+    shader_cache_file.Open(base_dir / "opengl.bin", CACHE_VERSION);
 
     if (!workers && !strict_context_required) {
         workers = CreateWorkers();
@@ -290,9 +289,12 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
             workers->QueueWork(std::move(work));
         }
     }};
-    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
+    const auto load_compute{[&](std::span<const char> key_data, FileEnvironment env) {
         ComputePipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        if (key_data.size() != sizeof(key)) {
+            return;
+        }
+        std::memcpy(&key, key_data.data(), sizeof(key));
         queue_work([this, key, env_ = std::move(env), &state, &callback](Context* ctx) mutable {
             ctx->pools.ReleaseContents();
             auto pipeline{CreateComputePipeline(ctx->pools, key, env_, true)};
@@ -307,9 +309,13 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         });
         ++state.total;
     }};
-    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
+    const auto load_graphics{[&](std::span<const char> key_data,
+                                 std::vector<FileEnvironment> envs) {
         GraphicsPipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        if (key_data.size() != sizeof(key)) {
+            return;
+        }
+        std::memcpy(&key, key_data.data(), sizeof(key));
         queue_work([this, key, envs_ = std::move(envs), &state, &callback](Context* ctx) mutable {
             boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
             for (auto& env : envs_) {
@@ -328,7 +334,7 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         });
         ++state.total;
     }};
-    LoadPipelines(stop_loading, shader_cache_filename, CACHE_VERSION, load_compute, load_graphics);
+    shader_cache_file.Load(stop_loading, load_compute, load_graphics);
 
     LOG_INFO(Render_OpenGL, "Total Pipeline Count: {}", state.total);
 
@@ -433,7 +439,7 @@ std::unique_ptr<GraphicsPipeline> ShaderCache::CreateGraphicsPipeline() {
     main_pools.ReleaseContents();
     auto pipeline{CreateGraphicsPipeline(main_pools, graphics_key, environments.Span(),
                                          use_asynchronous_shaders)};
-    if (!pipeline || shader_cache_filename.empty()) {
+    if (!pipeline || !shader_cache_file.IsOpen()) {
         return pipeline;
     }
     boost::container::static_vector<const GenericEnvironment*, Maxwell::MaxShaderProgram> env_ptrs;
@@ -442,7 +448,7 @@ std::unique_ptr<GraphicsPipeline> ShaderCache::CreateGraphicsPipeline() {
             env_ptrs.push_back(&environments.envs[index]);
         }
     }
-    SerializePipeline(graphics_key, env_ptrs, shader_cache_filename, CACHE_VERSION);
+    shader_cache_file.Append(graphics_key, env_ptrs);
     return pipeline;
 }
 
@@ -561,11 +567,10 @@ std::unique_ptr<ComputePipeline> ShaderCache::CreateComputePipeline(
 
     main_pools.ReleaseContents();
     auto pipeline{CreateComputePipeline(main_pools, key, env)};
-    if (!pipeline || shader_cache_filename.empty()) {
+    if (!pipeline || !shader_cache_file.IsOpen()) {
         return pipeline;
     }
-    SerializePipeline(key, std::array<const GenericEnvironment*, 1>{&env}, shader_cache_filename,
-                      CACHE_VERSION);
+    shader_cache_file.Append(key, std::array<const GenericEnvironment*, 1>{&env});
     return pipeline;
 }
 
@@ -14,6 +14,7 @@
 #include "video_core/renderer_opengl/gl_graphics_pipeline.h"
 #include "video_core/renderer_opengl/gl_shader_context.h"
 #include "video_core/shader_cache.h"
+#include "video_core/shader_environment.h"
 
 namespace Tegra {
 class MemoryManager;
@@ -84,7 +85,7 @@ private:
     Shader::Profile profile;
     Shader::HostTranslateInfo host_info;
 
-    std::filesystem::path shader_cache_filename;
+    VideoCommon::PipelineCacheFile shader_cache_file;
     std::unique_ptr<ShaderWorker> workers;
 };
 
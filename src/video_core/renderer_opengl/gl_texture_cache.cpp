@@ -452,6 +452,9 @@ OGLTexture MakeImage(const VideoCommon::ImageInfo& info, GLenum gl_internal_form
     case Settings::AstcRecompression::Bc3:
         return is_srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
         break;
+    case Settings::AstcRecompression::Bc7:
+        return is_srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+        break;
     default:
         return is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
     }
@@ -2,10 +2,13 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstring>
 #include <fstream>
 #include <memory>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "common/bit_cast.h"
@@ -56,6 +59,9 @@ using VideoCommon::GraphicsEnvironment;
 constexpr u32 CACHE_VERSION = 11;
 constexpr std::array<char, 8> VULKAN_CACHE_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'v', 'k', 'c', 'h'};
 
+// Pipelines used within this time after loading are built before the game starts on next boot
+constexpr std::chrono::seconds BOOT_RECORD_DURATION{15};
+
 template <typename Container>
 auto MakeSpan(Container& container) {
     return std::span(container.data(), container.size());
@@ -278,6 +284,11 @@ size_t GetTotalPipelineWorkers() {
 #endif
 }
 
+size_t GetTotalBackgroundPipelineWorkers() {
+    // Background builds run next to the game, leave it most of the cores
+    return std::max<size_t>(GetTotalPipelineWorkers() / 2, 1ULL);
+}
+
 } // Anonymous namespace
 
 size_t ComputePipelineCacheKey::Hash() const noexcept {
@@ -312,6 +323,7 @@ PipelineCache::PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
       use_vulkan_pipeline_cache{Settings::values.use_vulkan_driver_pipeline_cache.GetValue()},
       workers(device.HasBrokenParallelShaderCompiling() ? 1ULL : GetTotalPipelineWorkers(),
               "VkPipelineBuilder"),
+      background_workers(GetTotalBackgroundPipelineWorkers(), "VkPipelineBackground"),
       serialization_thread(1, "VkPipelineSerialization") {
     const auto& float_control{device.FloatControlProperties()};
     const VkDriverId driver_id{device.GetDriverID()};
@@ -412,6 +424,18 @@ PipelineCache::PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
 }
 
 PipelineCache::~PipelineCache() {
+    // A session closed before the recording window ended did not see its whole boot, the record
+    // is only updated after it. It is added to the previous record rather than replacing it.
+    if (is_recording_boot && std::chrono::steady_clock::now() >= boot_record_end) {
+        std::unordered_set<u64> hashes{
+            VideoCommon::LoadBootPipelines(boot_pipelines_filename, CACHE_VERSION)};
+        hashes.insert(boot_pipelines.begin(), boot_pipelines.end());
+        if (!hashes.empty()) {
+            const std::vector<u64> merged_hashes(hashes.begin(), hashes.end());
+            VideoCommon::SerializeBootPipelines(merged_hashes, boot_pipelines_filename,
+                                                CACHE_VERSION);
+        }
+    }
     if (use_vulkan_pipeline_cache && !vulkan_pipeline_cache_filename.empty()) {
         SerializeVulkanPipelineCache(vulkan_pipeline_cache_filename, vulkan_pipeline_cache,
                                      CACHE_VERSION);
@@ -450,12 +474,17 @@ ComputePipeline* PipelineCache::CurrentComputePipeline() {
         .shared_memory_size = qmd.shared_alloc,
         .workgroup_size{qmd.block_dim_x, qmd.block_dim_y, qmd.block_dim_z},
     };
+    if (is_recording_boot) [[unlikely]] {
+        RecordBootPipeline(key.Hash());
+    }
     const auto [pair, is_new]{compute_cache.try_emplace(key)};
     auto& pipeline{pair->second};
     if (!is_new) {
         return pipeline.get();
     }
-    pipeline = CreateComputePipeline(key, shader);
+    auto background_pipeline{TakeBackgroundBuild(background_compute, key)};
+    pipeline = background_pipeline ? std::move(*background_pipeline)
+                                   : CreateComputePipeline(key, shader);
     return pipeline.get();
 }
 
@@ -470,7 +499,7 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         LOG_ERROR(Common_Filesystem, "Failed to create pipeline cache directories");
         return;
     }
-    pipeline_cache_filename = base_dir / "vulkan.bin";
+    pipeline_cache_file.Open(base_dir / "vulkan.bin", CACHE_VERSION);
 
     if (use_vulkan_pipeline_cache) {
         vulkan_pipeline_cache_filename = base_dir / "vulkan_pipelines.bin";
@@ -478,6 +507,29 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
             LoadVulkanPipelineCache(vulkan_pipeline_cache_filename, CACHE_VERSION);
     }
 
+    // Pipelines the previous session used while booting gate the boot, the rest are built in the
+    // background. Without a record everything is built before booting.
+    boot_pipelines_filename = base_dir / "vulkan_boot.bin";
+    std::unordered_set<u64> boot_hashes;
+    if (!device.HasBrokenParallelShaderCompiling()) {
+        boot_hashes = VideoCommon::LoadBootPipelines(boot_pipelines_filename, CACHE_VERSION);
+    }
+    const auto is_boot_pipeline{
+        [&](u64 hash) { return boot_hashes.empty() || boot_hashes.contains(hash); }};
+    const auto has_dynamic_features{[this](const GraphicsPipelineCacheKey& key) {
+        return (key.state.extended_dynamic_state != 0) ==
+                   dynamic_features.has_extended_dynamic_state &&
+               (key.state.extended_dynamic_state_2 != 0) ==
+                   dynamic_features.has_extended_dynamic_state_2 &&
+               (key.state.extended_dynamic_state_2_extra != 0) ==
+                   dynamic_features.has_extended_dynamic_state_2_extra &&
+               (key.state.extended_dynamic_state_3_blend != 0) ==
+                   dynamic_features.has_extended_dynamic_state_3_blend &&
+               (key.state.extended_dynamic_state_3_enables != 0) ==
+                   dynamic_features.has_extended_dynamic_state_3_enables &&
+               (key.state.dynamic_vertex_input != 0) == dynamic_features.has_dynamic_vertex_input;
+    }};
+
     struct {
         std::mutex mutex;
         size_t total{};
@@ -489,9 +541,12 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
     if (device.IsKhrPipelineExecutablePropertiesEnabled()) {
         state.statistics = std::make_unique<PipelineStatistics>(device);
     }
-    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
+    const auto load_compute{[&](std::span<const char> key_data, FileEnvironment env) {
         ComputePipelineCacheKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        if (key_data.size() != sizeof(key)) {
+            return;
+        }
+        std::memcpy(&key, key_data.data(), sizeof(key));
 
         workers.QueueWork([this, key, env_ = std::move(env), &state, &callback]() mutable {
             ShaderPools pools;
@@ -507,21 +562,15 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         });
         ++state.total;
     }};
-    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
+    const auto load_graphics{[&](std::span<const char> key_data,
+                                 std::vector<FileEnvironment> envs) {
         GraphicsPipelineCacheKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
-
-        if ((key.state.extended_dynamic_state != 0) !=
-                dynamic_features.has_extended_dynamic_state ||
-            (key.state.extended_dynamic_state_2 != 0) !=
-                dynamic_features.has_extended_dynamic_state_2 ||
-            (key.state.extended_dynamic_state_2_extra != 0) !=
-                dynamic_features.has_extended_dynamic_state_2_extra ||
-            (key.state.extended_dynamic_state_3_blend != 0) !=
-                dynamic_features.has_extended_dynamic_state_3_blend ||
-            (key.state.extended_dynamic_state_3_enables != 0) !=
-                dynamic_features.has_extended_dynamic_state_3_enables ||
-            (key.state.dynamic_vertex_input != 0) != dynamic_features.has_dynamic_vertex_input) {
+        if (key_data.size() != sizeof(key)) {
+            return;
+        }
+        std::memcpy(&key, key_data.data(), sizeof(key));
+
+        if (!has_dynamic_features(key)) {
             return;
         }
         workers.QueueWork([this, key, envs_ = std::move(envs), &state, &callback]() mutable {
@@ -544,10 +593,59 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         });
         ++state.total;
     }};
-    VideoCommon::LoadPipelines(stop_loading, pipeline_cache_filename, CACHE_VERSION, load_compute,
-                               load_graphics);
+    // Pipelines built in the background only keep their key, their environments are read from
+    // the file when they are built
+    static_assert(sizeof(ComputePipelineCacheKey) != sizeof(GraphicsPipelineCacheKey));
+    const auto is_deferred{[&](std::span<const char> key_data) {
+        if (key_data.size() == sizeof(ComputePipelineCacheKey)) {
+            ComputePipelineCacheKey key;
+            std::memcpy(&key, key_data.data(), sizeof(key));
+            if (is_boot_pipeline(key.Hash())) {
+                return false;
+            }
+            auto build{std::make_shared<BackgroundBuild<ComputePipeline>>()};
+            build->build = [this, key]() -> std::unique_ptr<ComputePipeline> {
+                auto envs{pipeline_cache_file.Find(key)};
+                if (!envs || envs->size() != 1) {
+                    return nullptr;
+                }
+                ShaderPools pools;
+                return CreateComputePipeline(pools, key, envs->front(), nullptr, false);
+            };
+            background_compute.emplace(key, std::move(build));
+            return true;
+        }
+        if (key_data.size() == sizeof(GraphicsPipelineCacheKey)) {
+            GraphicsPipelineCacheKey key;
+            std::memcpy(&key, key_data.data(), sizeof(key));
+            if (is_boot_pipeline(key.Hash())) {
+                return false;
+            }
+            if (!has_dynamic_features(key)) {
+                return true;
+            }
+            auto build{std::make_shared<BackgroundBuild<GraphicsPipeline>>()};
+            build->build = [this, key]() -> std::unique_ptr<GraphicsPipeline> {
+                auto envs{pipeline_cache_file.Find(key)};
+                if (!envs) {
+                    return nullptr;
+                }
+                ShaderPools pools;
+                boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
+                for (auto& env : *envs) {
+                    env_ptrs.push_back(&env);
+                }
+                return CreateGraphicsPipeline(pools, key, MakeSpan(env_ptrs), nullptr, false);
+            };
+            background_graphics.emplace(key, std::move(build));
+            return true;
+        }
+        return false;
+    }};
+    pipeline_cache_file.Load(stop_loading, load_compute, load_graphics, is_deferred);
 
-    LOG_INFO(Render_Vulkan, "Total Pipeline Count: {}", state.total);
+    LOG_INFO(Render_Vulkan, "Total Pipeline Count: {}, {} built in the background", state.total,
+             background_compute.size() + background_graphics.size());
 
     std::unique_lock lock{state.mutex};
     callback(VideoCore::LoadCallbackStage::Build, 0, state.total);
@@ -556,6 +654,19 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
 
     workers.WaitForRequests(stop_loading);
 
+    if (!stop_loading.stop_requested()) {
+        // Nothing else touches the background builds until the game starts
+        for (const auto& [key, build] : background_compute) {
+            background_workers.QueueWork([this, build] { RunBackgroundBuild(*build); });
+        }
+        for (const auto& [key, build] : background_graphics) {
+            background_workers.QueueWork([this, build] { RunBackgroundBuild(*build); });
+        }
+        boot_pipelines.clear();
+        boot_record_end = std::chrono::steady_clock::now() + BOOT_RECORD_DURATION;
+        is_recording_boot = true;
+    }
+
     if (use_vulkan_pipeline_cache) {
         SerializeVulkanPipelineCache(vulkan_pipeline_cache_filename, vulkan_pipeline_cache,
                                      CACHE_VERSION);
@@ -567,10 +678,14 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
 }
 
 GraphicsPipeline* PipelineCache::CurrentGraphicsPipelineSlowPath() {
+    if (is_recording_boot) [[unlikely]] {
+        RecordBootPipeline(graphics_key.Hash());
+    }
     const auto [pair, is_new]{graphics_cache.try_emplace(graphics_key)};
     auto& pipeline{pair->second};
     if (is_new) {
-        pipeline = CreateGraphicsPipeline();
+        auto background_pipeline{TakeBackgroundBuild(background_graphics, graphics_key)};
+        pipeline = background_pipeline ? std::move(*background_pipeline) : CreateGraphicsPipeline();
     }
     if (!pipeline) {
         return nullptr;
@@ -713,7 +828,7 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline() {
     main_pools.ReleaseContents();
     auto pipeline{
         CreateGraphicsPipeline(main_pools, graphics_key, environments.Span(), nullptr, true)};
-    if (!pipeline || pipeline_cache_filename.empty()) {
+    if (!pipeline || !pipeline_cache_file.IsOpen()) {
         return pipeline;
     }
     serialization_thread.QueueWork([this, key = graphics_key, envs = std::move(environments.envs)] {
@@ -724,7 +839,7 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline() {
                 env_ptrs.push_back(&envs[index]);
             }
         }
-        SerializePipeline(key, env_ptrs, pipeline_cache_filename, CACHE_VERSION);
+        pipeline_cache_file.Append(key, env_ptrs);
     });
     return pipeline;
 }
@@ -738,12 +853,11 @@ std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
 
     main_pools.ReleaseContents();
     auto pipeline{CreateComputePipeline(main_pools, key, env, nullptr, true)};
-    if (!pipeline || pipeline_cache_filename.empty()) {
+    if (!pipeline || !pipeline_cache_file.IsOpen()) {
         return pipeline;
     }
     serialization_thread.QueueWork([this, key, env_ = std::move(env)] {
-        SerializePipeline(key, std::array<const GenericEnvironment*, 1>{&env_},
-                          pipeline_cache_filename, CACHE_VERSION);
+        pipeline_cache_file.Append(key, std::array<const GenericEnvironment*, 1>{&env_});
     });
     return pipeline;
 }
@@ -784,6 +898,58 @@ std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
     return nullptr;
 }
 
+template <typename Pipeline>
+void PipelineCache::RunBackgroundBuild(BackgroundBuild<Pipeline>& build) {
+    if (build.is_claimed.test_and_set()) {
+        return;
+    }
+    auto pipeline{build.build()};
+    // Nothing calls it again, release what it captured
+    build.build = {};
+
+    std::scoped_lock lock{background_mutex};
+    build.pipeline = std::move(pipeline);
+    build.is_done = true;
+    background_condition.notify_all();
+}
+
+template <typename Key, typename Pipeline>
+std::optional<std::unique_ptr<Pipeline>> PipelineCache::TakeBackgroundBuild(
+    BackgroundBuilds<Key, Pipeline>& builds, const Key& key) {
+    std::unique_lock lock{background_mutex};
+    const auto it{builds.find(key)};
+    if (it == builds.end()) {
+        return std::nullopt;
+    }
+    const std::shared_ptr<BackgroundBuild<Pipeline>> build{std::move(it->second)};
+    builds.erase(it);
+    lock.unlock();
+
+    if (!build->is_claimed.test_and_set()) {
+        // A draw needs it now, build it here instead of waiting for its turn on the workers
+        auto pipeline{build->build()};
+        // The worker that was queued for it still holds the build until it gets to it
+        build->build = {};
+        return pipeline;
+    }
+    lock.lock();
+    background_condition.wait(lock, [&build] { return build->is_done; });
+    return std::move(build->pipeline);
+}
+
+void PipelineCache::RecordBootPipeline(u64 hash) {
+    if (std::chrono::steady_clock::now() < boot_record_end) {
+        boot_pipelines.insert(hash);
+        return;
+    }
+    is_recording_boot = false;
+    serialization_thread.QueueWork(
+        [this, hashes = std::vector<u64>(boot_pipelines.begin(), boot_pipelines.end())] {
+            VideoCommon::SerializeBootPipelines(hashes, boot_pipelines_filename, CACHE_VERSION);
+        });
+    boot_pipelines.clear();
+}
+
 void PipelineCache::SerializeVulkanPipelineCache(const std::filesystem::path& filename,
                                                  const vk::PipelineCache& pipeline_cache,
                                                  u32 cache_version) try {
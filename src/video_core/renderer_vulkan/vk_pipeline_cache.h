@@ -4,15 +4,22 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/common_types.h"
 #include "common/thread_worker.h"
+#include "common/unique_function.h"
 #include "shader_recompiler/frontend/ir/basic_block.h"
 #include "shader_recompiler/frontend/ir/value.h"
 #include "shader_recompiler/frontend/maxwell/control_flow.h"
@@ -27,6 +34,7 @@
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_texture_cache.h"
 #include "video_core/shader_cache.h"
+#include "video_core/shader_environment.h"
 
 namespace Core {
 class System;
@@ -114,6 +122,18 @@ public:
                            const VideoCore::DiskResourceLoadCallback& callback);
 
 private:
+    /// Pipeline from the disk cache that is not needed to boot, built after the game has started.
+    template <typename Pipeline>
+    struct BackgroundBuild {
+        Common::UniqueFunction<std::unique_ptr<Pipeline>> build;
+        std::unique_ptr<Pipeline> pipeline;
+        std::atomic_flag is_claimed;
+        bool is_done{};
+    };
+
+    template <typename Key, typename Pipeline>
+    using BackgroundBuilds = std::unordered_map<Key, std::shared_ptr<BackgroundBuild<Pipeline>>>;
+
     [[nodiscard]] GraphicsPipeline* CurrentGraphicsPipelineSlowPath();
 
     [[nodiscard]] GraphicsPipeline* BuiltPipeline(GraphicsPipeline* pipeline) const noexcept;
@@ -134,6 +154,19 @@ private:
                                                            PipelineStatistics* statistics,
                                                            bool build_in_parallel);
 
+    /// Builds a background pipeline on a worker, unless the GPU thread has claimed it already.
+    template <typename Pipeline>
+    void RunBackgroundBuild(BackgroundBuild<Pipeline>& build);
+
+    /// Removes the background build of key, building it on the calling thread when no worker has
+    /// started it yet. Returns nullopt when key has no background build.
+    template <typename Key, typename Pipeline>
+    [[nodiscard]] std::optional<std::unique_ptr<Pipeline>> TakeBackgroundBuild(
+        BackgroundBuilds<Key, Pipeline>& builds, const Key& key);
+
+    /// Records a pipeline used during the first seconds of the session.
+    void RecordBootPipeline(u64 hash);
+
     void SerializeVulkanPipelineCache(const std::filesystem::path& filename,
                                       const vk::PipelineCache& pipeline_cache, u32 cache_version);
 
@@ -162,12 +195,23 @@ private:
     Shader::Profile profile;
     Shader::HostTranslateInfo host_info;
 
-    std::filesystem::path pipeline_cache_filename;
+    VideoCommon::PipelineCacheFile pipeline_cache_file;
 
     std::filesystem::path vulkan_pipeline_cache_filename;
     vk::PipelineCache vulkan_pipeline_cache;
 
+    std::filesystem::path boot_pipelines_filename;
+    std::unordered_set<u64> boot_pipelines;
+    std::chrono::steady_clock::time_point boot_record_end;
+    bool is_recording_boot{};
+
+    std::mutex background_mutex;
+    std::condition_variable background_condition;
+    BackgroundBuilds<ComputePipelineCacheKey, ComputePipeline> background_compute;
+    BackgroundBuilds<GraphicsPipelineCacheKey, GraphicsPipeline> background_graphics;
+
     Common::ThreadWorker workers;
+    Common::ThreadWorker background_workers;
     Common::ThreadWorker serialization_thread;
     DynamicFeatures dynamic_features;
 };
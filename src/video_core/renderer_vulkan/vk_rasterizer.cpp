@@ -841,7 +841,12 @@ std::optional<FramebufferTextureInfo> RasterizerVulkan::AccelerateDisplay(
 
 void RasterizerVulkan::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
-    pipeline_cache.LoadDiskResources(title_id, stop_loading, callback);
+    if (Settings::values.use_disk_texture_cache.GetValue()) {
+        texture_cache.LoadDiskResources(title_id);
+    }
+    if (Settings::values.use_disk_shader_cache.GetValue()) {
+        pipeline_cache.LoadDiskResources(title_id, stop_loading, callback);
+    }
 }
 
 void RasterizerVulkan::FlushWork() {
@@ -2,10 +2,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 #include <optional>
+#include <sstream>
+#include <string>
 #include <utility>
 
 #include "common/assert.h"
@@ -16,6 +20,7 @@
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "common/polyfill_ranges.h"
+#include "common/zstd_compression.h"
 #include "shader_recompiler/environment.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/memory_manager.h"
@@ -25,10 +30,48 @@
 
 namespace VideoCommon {
 
-constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
+constexpr std::array<char, 8> MAGIC_NUMBER{'s', 'u', 'y', 'u', 'p', 'i', 'p', 'e'};
+constexpr u32 FORMAT_VERSION = 1;
+constexpr std::array<char, 8> BOOT_MAGIC_NUMBER{'s', 'u', 'y', 'u', 'b', 'o', 'o', 't'};
+constexpr u32 MAX_BOOT_PIPELINES = 1U << 20;
 
 constexpr size_t INST_SIZE = sizeof(u64);
 
+enum class RecordType : u32 {
+    Environment,
+    Pipeline,
+    Index,
+};
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    u32 format_version;
+    u32 cache_version;
+    u64 index_offset;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+struct RecordHeader {
+    RecordType type;
+    u32 size;
+};
+
+struct EnvironmentRecord {
+    u64 hash;
+    u64 uncompressed_size;
+};
+
+struct PipelineRecord {
+    u64 key_hash;
+    u32 key_size;
+    u32 num_environments;
+};
+
+struct IndexRecord {
+    u32 num_environments;
+    u32 num_pipelines;
+};
+
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
 static u64 MakeCbufKey(u32 index, u32 offset) {
@@ -193,7 +236,7 @@ void GenericEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
 
-void GenericEnvironment::Serialize(std::ofstream& file) const {
+void GenericEnvironment::Serialize(std::ostream& file) const {
     const u64 code_size{static_cast<u64>(CachedSizeBytes())};
     const u64 num_texture_types{static_cast<u64>(texture_types.size())};
     const u64 num_texture_pixel_formats{static_cast<u64>(texture_pixel_formats.size())};
@@ -448,7 +491,7 @@ u32 ComputeEnvironment::ReadViewportTransformState() {
     return viewport_transform_state;
 }
 
-void FileEnvironment::Deserialize(std::ifstream& file) {
+void FileEnvironment::Deserialize(std::istream& file) {
     u64 code_size{};
     u64 num_texture_types{};
     u64 num_texture_pixel_formats{};
@@ -582,93 +625,473 @@ std::optional<Shader::ReplaceConstant> FileEnvironment::GetReplaceConstBuffer(u3
     return it->second;
 }
 
-void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version) try {
-    std::ofstream file(filename, std::ios::binary | std::ios::ate | std::ios::app);
-    file.exceptions(std::ifstream::failbit);
-    if (!file.is_open()) {
+PipelineCacheFile::PipelineCacheFile() = default;
+
+PipelineCacheFile::~PipelineCacheFile() {
+    Close();
+}
+
+void PipelineCacheFile::Open(const std::filesystem::path& filename_, u32 cache_version_) {
+    Close();
+
+    std::scoped_lock lock{mutex};
+    filename = filename_;
+    cache_version = cache_version_;
+    mapped_file.Open(filename);
+    if (!ReadIndex()) {
+        environments.clear();
+        pipelines.clear();
+        pipeline_lookup.clear();
+        CreateFile();
+        return;
+    }
+    file.Open(filename, Common::FS::FileAccessMode::ReadWrite);
+    if (!file.IsOpen()) {
         LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
                   Common::FS::PathToUTF8String(filename));
         return;
     }
-    if (file.tellp() == 0) {
-        // Write header
-        file.write(MAGIC_NUMBER.data(), MAGIC_NUMBER.size())
-            .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version));
+    if (is_index_dirty) {
+        WriteIndex();
+    }
+}
+
+void PipelineCacheFile::Close() {
+    std::scoped_lock lock{mutex};
+    if (file.IsOpen() && is_index_dirty) {
+        WriteIndex();
     }
+    file.Close();
+    mapped_file.Close();
+    index_offset = 0;
+    environments.clear();
+    pipelines.clear();
+    pipeline_lookup.clear();
+}
+
+bool PipelineCacheFile::IsOpen() const {
+    std::scoped_lock lock{mutex};
+    return file.IsOpen();
+}
+
+void PipelineCacheFile::Append(std::span<const char> key,
+                               std::span<const GenericEnvironment* const> envs) {
     if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
         return;
     }
-    const u32 num_envs{static_cast<u32>(envs.size())};
-    file.write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs));
-    for (const GenericEnvironment* const env : envs) {
-        env->Serialize(file);
+    std::scoped_lock lock{mutex};
+    if (!file.IsOpen()) {
+        return;
     }
-    file.write(key.data(), key.size_bytes());
-
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
+    try {
+        AppendRecords(key, envs);
+    } catch (const std::ios_base::failure& e) {
+        LOG_ERROR(Common_Filesystem, "{}", e.what());
+        // The file can't be trusted after a partial write, start over on the next boot
+        file.Close();
+        mapped_file.Close();
+        if (!Common::FS::RemoveFile(filename)) {
+            LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
+                      Common::FS::PathToUTF8String(filename));
+        }
     }
 }
 
-void LoadPipelines(
-    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics) try {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
+void PipelineCacheFile::AppendRecords(std::span<const char> key,
+                                      std::span<const GenericEnvironment* const> envs) {
+    const u64 key_hash{Common::CityHash64(key.data(), key.size())};
+    if (FindPipeline(key, key_hash)) {
         return;
     }
-    file.exceptions(std::ifstream::failbit);
-    const auto end{file.tellg()};
-    file.seekg(0, std::ios::beg);
 
-    std::array<char, 8> magic_number;
-    u32 cache_version;
-    file.read(magic_number.data(), magic_number.size())
-        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
-    if (magic_number != MAGIC_NUMBER || cache_version != expected_cache_version) {
-        file.close();
-        if (Common::FS::RemoveFile(filename)) {
-            if (magic_number != MAGIC_NUMBER) {
-                LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
-            }
-            if (cache_version != expected_cache_version) {
-                LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
-            }
-        } else {
-            LOG_ERROR(Common_Filesystem,
-                      "Invalid pipeline cache file and failed to delete it in \"{}\"",
-                      Common::FS::PathToUTF8String(filename));
+    DropIndex();
+    if (!file.Seek(0, Common::FS::SeekOrigin::End)) {
+        throw std::ios_base::failure("Failed to seek pipeline cache file");
+    }
+    const auto write{[this](std::span<const char> data) {
+        if (file.WriteSpan(data) != data.size()) {
+            throw std::ios_base::failure("Failed to write pipeline cache file");
         }
-        return;
+    }};
+    const auto write_object{[&](const auto& object) {
+        write(std::span(reinterpret_cast<const char*>(&object), sizeof(object)));
+    }};
+
+    std::vector<u64> env_hashes;
+    env_hashes.reserve(envs.size());
+    for (const GenericEnvironment* const env : envs) {
+        std::ostringstream stream;
+        stream.exceptions(std::ios::failbit);
+        env->Serialize(stream);
+        const std::string contents{std::move(stream).str()};
+        const u64 hash{Common::CityHash64(contents.data(), contents.size())};
+        env_hashes.push_back(hash);
+        if (environments.contains(hash)) {
+            continue;
+        }
+        const std::vector<u8> compressed{Common::Compression::CompressDataZSTDDefault(
+            reinterpret_cast<const u8*>(contents.data()), contents.size())};
+        const u64 offset{static_cast<u64>(file.Tell())};
+        write_object(RecordHeader{
+            .type = RecordType::Environment,
+            .size = static_cast<u32>(sizeof(EnvironmentRecord) + compressed.size()),
+        });
+        write_object(EnvironmentRecord{
+            .hash = hash,
+            .uncompressed_size = contents.size(),
+        });
+        write(std::span(reinterpret_cast<const char*>(compressed.data()), compressed.size()));
+        environments.emplace(hash, offset);
     }
-    while (file.tellg() != end) {
+
+    const u64 offset{static_cast<u64>(file.Tell())};
+    write_object(RecordHeader{
+        .type = RecordType::Pipeline,
+        .size = static_cast<u32>(sizeof(PipelineRecord) + env_hashes.size() * sizeof(u64) +
+                                 key.size()),
+    });
+    write_object(PipelineRecord{
+        .key_hash = key_hash,
+        .key_size = static_cast<u32>(key.size()),
+        .num_environments = static_cast<u32>(env_hashes.size()),
+    });
+    write(std::span(reinterpret_cast<const char*>(env_hashes.data()),
+                    env_hashes.size() * sizeof(u64)));
+    write(key);
+    void(file.Flush());
+
+    pipeline_lookup.emplace(key_hash, pipelines.size());
+    pipelines.push_back({key_hash, offset});
+    is_index_dirty = true;
+}
+
+std::optional<std::vector<FileEnvironment>> PipelineCacheFile::Find(std::span<const char> key) {
+    std::scoped_lock lock{mutex};
+    const auto pipeline{FindPipeline(key, Common::CityHash64(key.data(), key.size()))};
+    if (!pipeline) {
+        return std::nullopt;
+    }
+    return ReadEnvironments(pipeline->env_hashes);
+}
+
+void PipelineCacheFile::Load(
+    std::stop_token stop_loading,
+    Common::UniqueFunction<void, std::span<const char>, FileEnvironment> load_compute,
+    Common::UniqueFunction<void, std::span<const char>, std::vector<FileEnvironment>>
+        load_graphics,
+    Common::UniqueFunction<bool, std::span<const char>> is_deferred) {
+    std::scoped_lock lock{mutex};
+    for (const IndexEntry& entry : pipelines) {
         if (stop_loading.stop_requested()) {
             return;
         }
-        u32 num_envs{};
-        file.read(reinterpret_cast<char*>(&num_envs), sizeof(num_envs));
-        std::vector<FileEnvironment> envs(num_envs);
-        for (FileEnvironment& env : envs) {
-            env.Deserialize(file);
+        const auto pipeline{ReadPipeline(entry.offset)};
+        if (!pipeline || (is_deferred && is_deferred(pipeline->key))) {
+            continue;
+        }
+        auto envs{ReadEnvironments(pipeline->env_hashes)};
+        if (!envs || envs->empty()) {
+            continue;
         }
-        if (envs.front().ShaderStage() == Shader::Stage::Compute) {
-            load_compute(file, std::move(envs.front()));
+        if (envs->front().ShaderStage() == Shader::Stage::Compute) {
+            load_compute(pipeline->key, std::move(envs->front()));
         } else {
-            load_graphics(file, std::move(envs));
+            load_graphics(pipeline->key, std::move(*envs));
+        }
+    }
+}
+
+bool PipelineCacheFile::ReadIndex() {
+    const std::span<const u8> data{mapped_file.Data()};
+    if (data.size() < sizeof(FileHeader)) {
+        return false;
+    }
+    FileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != MAGIC_NUMBER || header.format_version != FORMAT_VERSION) {
+        LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
+        return false;
+    }
+    if (header.cache_version != cache_version) {
+        LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
+        return false;
+    }
+    const auto read_record{[&](u64 offset, RecordHeader& record) {
+        if (offset + sizeof(record) > data.size()) {
+            return false;
+        }
+        std::memcpy(&record, data.data() + offset, sizeof(record));
+        return offset + sizeof(record) + record.size <= data.size();
+    }};
+
+    u64 offset{sizeof(FileHeader)};
+    if (header.index_offset != 0) {
+        RecordHeader record;
+        IndexRecord index;
+        if (!read_record(header.index_offset, record) || record.type != RecordType::Index ||
+            record.size < sizeof(index)) {
+            LOG_ERROR(Common_Filesystem, "Invalid pipeline cache index");
+            return false;
+        }
+        const u8* const payload{data.data() + header.index_offset + sizeof(record)};
+        std::memcpy(&index, payload, sizeof(index));
+        const size_t num_entries{size_t{index.num_environments} + index.num_pipelines};
+        if (record.size != sizeof(index) + num_entries * sizeof(IndexEntry)) {
+            LOG_ERROR(Common_Filesystem, "Invalid pipeline cache index");
+            return false;
+        }
+        std::vector<IndexEntry> entries(num_entries);
+        std::memcpy(entries.data(), payload + sizeof(index), num_entries * sizeof(IndexEntry));
+        for (size_t i = 0; i < index.num_environments; ++i) {
+            environments.emplace(entries[i].hash, entries[i].offset);
+        }
+        for (size_t i = index.num_environments; i < num_entries; ++i) {
+            pipeline_lookup.emplace(entries[i].hash, pipelines.size());
+            pipelines.push_back(entries[i]);
+        }
+        offset = header.index_offset + sizeof(record) + record.size;
+    }
+
+    // Records appended after the index was written have to be scanned
+    RecordHeader record;
+    while (read_record(offset, record)) {
+        const u8* const payload{data.data() + offset + sizeof(record)};
+        if (record.type == RecordType::Environment && record.size >= sizeof(EnvironmentRecord)) {
+            EnvironmentRecord environment;
+            std::memcpy(&environment, payload, sizeof(environment));
+            environments.emplace(environment.hash, offset);
+        } else if (record.type == RecordType::Pipeline && record.size >= sizeof(PipelineRecord)) {
+            PipelineRecord pipeline;
+            std::memcpy(&pipeline, payload, sizeof(pipeline));
+            pipeline_lookup.emplace(pipeline.key_hash, pipelines.size());
+            pipelines.push_back({pipeline.key_hash, offset});
+        } else if (record.type != RecordType::Index) {
+            break;
+        }
+        is_index_dirty = true;
+        offset += sizeof(record) + record.size;
+    }
+    if (!is_index_dirty) {
+        index_offset = header.index_offset;
+    }
+    if (offset != data.size()) {
+        // A write was interrupted, drop the incomplete record so appends stay parseable
+        LOG_WARNING(Common_Filesystem, "Discarding {} bytes at the end of the pipeline cache",
+                    data.size() - offset);
+        mapped_file.Close();
+        Common::FS::IOFile truncate_file{filename, Common::FS::FileAccessMode::ReadWrite};
+        if (!truncate_file.SetSize(offset)) {
+            return false;
+        }
+        mapped_file.Open(filename);
+    }
+    return true;
+}
+
+void PipelineCacheFile::WriteIndex() {
+    std::vector<IndexEntry> entries;
+    entries.reserve(environments.size() + pipelines.size());
+    for (const auto& [hash, offset] : environments) {
+        entries.push_back({hash, offset});
+    }
+    entries.insert(entries.end(), pipelines.begin(), pipelines.end());
+
+    const IndexRecord index{
+        .num_environments = static_cast<u32>(environments.size()),
+        .num_pipelines = static_cast<u32>(pipelines.size()),
+    };
+    const RecordHeader record{
+        .type = RecordType::Index,
+        .size = static_cast<u32>(sizeof(index) + entries.size() * sizeof(IndexEntry)),
+    };
+    if (!file.Seek(0, Common::FS::SeekOrigin::End)) {
+        return;
+    }
+    const u64 new_index_offset{static_cast<u64>(file.Tell())};
+    // The header is only pointed at the new index once it has been completely written
+    if (!file.WriteObject(record) || !file.WriteObject(index) ||
+        file.WriteSpan(std::span<const IndexEntry>(entries)) != entries.size() || !file.Flush() ||
+        !file.Seek(static_cast<s64>(offsetof(FileHeader, index_offset))) ||
+        !file.WriteObject(new_index_offset) || !file.Flush()) {
+        LOG_ERROR(Common_Filesystem, "Failed to write pipeline cache index");
+        return;
+    }
+    index_offset = new_index_offset;
+    is_index_dirty = false;
+}
+
+void PipelineCacheFile::DropIndex() {
+    if (index_offset == 0) {
+        return;
+    }
+    // Unlink the index before cutting it off, if that is interrupted the next boot scans the file
+    if (!file.Seek(static_cast<s64>(offsetof(FileHeader, index_offset))) ||
+        !file.WriteObject(u64{0}) || !file.Flush()) {
+        throw std::ios_base::failure("Failed to write pipeline cache file");
+    }
+    // Mapped files can't be resized on every platform
+    mapped_file.Close();
+    if (!file.SetSize(index_offset)) {
+        // Records are appended after it instead, scans skip stale indices
+        LOG_WARNING(Common_Filesystem, "Failed to remove the pipeline cache index");
+    }
+    mapped_file.Open(filename);
+    index_offset = 0;
+}
+
+void PipelineCacheFile::CreateFile() {
+    mapped_file.Close();
+    file.Open(filename, Common::FS::FileAccessMode::Write);
+    const FileHeader header{
+        .magic = MAGIC_NUMBER,
+        .format_version = FORMAT_VERSION,
+        .cache_version = cache_version,
+        .index_offset = 0,
+    };
+    if (!file.IsOpen() || !file.WriteObject(header) || !file.Flush()) {
+        LOG_ERROR(Common_Filesystem, "Failed to create pipeline cache file {}",
+                  Common::FS::PathToUTF8String(filename));
+        file.Close();
+        return;
+    }
+    // Reopen for reading too, records already written are read back to compare keys
+    file.Open(filename, Common::FS::FileAccessMode::ReadWrite);
+    index_offset = 0;
+    is_index_dirty = false;
+}
+
+std::span<const u8> PipelineCacheFile::ReadRecord(u64 offset) {
+    const std::span<const u8> data{mapped_file.Data()};
+    RecordHeader record;
+    if (offset + sizeof(record) <= data.size()) {
+        std::memcpy(&record, data.data() + offset, sizeof(record));
+        if (offset + sizeof(record) + record.size <= data.size()) {
+            return data.subspan(offset + sizeof(record), record.size);
+        }
+    }
+    // Records appended after the file was mapped are read from the file instead
+    if (!file.Seek(static_cast<s64>(offset)) || !file.ReadObject(record)) {
+        return {};
+    }
+    read_buffer.resize(record.size);
+    if (file.ReadSpan(std::span(read_buffer)) != read_buffer.size()) {
+        return {};
+    }
+    return read_buffer;
+}
+
+std::optional<PipelineCacheFile::Pipeline> PipelineCacheFile::ReadPipeline(u64 offset) {
+    const std::span<const u8> record{ReadRecord(offset)};
+    PipelineRecord header;
+    if (record.size() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, record.data(), sizeof(header));
+    const size_t key_offset{sizeof(header) + header.num_environments * sizeof(u64)};
+    if (record.size() != key_offset + header.key_size) {
+        return std::nullopt;
+    }
+    Pipeline pipeline;
+    pipeline.env_hashes.resize(header.num_environments);
+    std::memcpy(pipeline.env_hashes.data(), record.data() + sizeof(header),
+                header.num_environments * sizeof(u64));
+    const auto key{record.subspan(key_offset)};
+    pipeline.key.assign(key.begin(), key.end());
+    return pipeline;
+}
+
+std::optional<PipelineCacheFile::Pipeline> PipelineCacheFile::FindPipeline(
+    std::span<const char> key, u64 key_hash) {
+    const auto [first, last]{pipeline_lookup.equal_range(key_hash)};
+    for (auto it = first; it != last; ++it) {
+        auto pipeline{ReadPipeline(pipelines[it->second].offset)};
+        if (pipeline && std::ranges::equal(pipeline->key, key)) {
+            return pipeline;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::vector<FileEnvironment>> PipelineCacheFile::ReadEnvironments(
+    std::span<const u64> hashes) try {
+    std::vector<FileEnvironment> envs;
+    envs.reserve(hashes.size());
+    for (const u64 hash : hashes) {
+        const auto it{environments.find(hash)};
+        const std::span<const u8> record{it != environments.end() ? ReadRecord(it->second)
+                                                                  : std::span<const u8>{}};
+        EnvironmentRecord header;
+        if (record.size() < sizeof(header)) {
+            LOG_ERROR(Common_Filesystem, "Missing pipeline cache environment {:016x}", hash);
+            return std::nullopt;
         }
+        std::memcpy(&header, record.data(), sizeof(header));
+        const std::vector<u8> contents{
+            Common::Compression::DecompressDataZSTD(record.subspan(sizeof(header)))};
+        if (contents.size() != header.uncompressed_size) {
+            LOG_ERROR(Common_Filesystem, "Invalid pipeline cache environment {:016x}", hash);
+            return std::nullopt;
+        }
+        std::istringstream stream{
+            std::string(reinterpret_cast<const char*>(contents.data()), contents.size())};
+        stream.exceptions(std::ios::failbit);
+        envs.emplace_back().Deserialize(stream);
+    }
+    return envs;
+
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Invalid pipeline cache environment: {}", e.what());
+    return std::nullopt;
+}
+
+void SerializeBootPipelines(std::span<const u64> hashes, const std::filesystem::path& filename,
+                            u32 cache_version) try {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.exceptions(std::ifstream::failbit);
+    if (!file.is_open()) {
+        LOG_ERROR(Common_Filesystem, "Failed to open boot pipeline file {}",
+                  Common::FS::PathToUTF8String(filename));
+        return;
     }
+    const u32 num_hashes{static_cast<u32>(hashes.size())};
+    file.write(BOOT_MAGIC_NUMBER.data(), BOOT_MAGIC_NUMBER.size())
+        .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version))
+        .write(reinterpret_cast<const char*>(&num_hashes), sizeof(num_hashes))
+        .write(reinterpret_cast<const char*>(hashes.data()), hashes.size_bytes());
 
 } catch (const std::ios_base::failure& e) {
     LOG_ERROR(Common_Filesystem, "{}", e.what());
     if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
+        LOG_ERROR(Common_Filesystem, "Failed to delete boot pipeline file {}",
                   Common::FS::PathToUTF8String(filename));
     }
 }
 
+std::unordered_set<u64> LoadBootPipelines(const std::filesystem::path& filename,
+                                          u32 expected_cache_version) try {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+    file.exceptions(std::ifstream::failbit);
+
+    std::array<char, 8> magic_number;
+    u32 cache_version;
+    u32 num_hashes;
+    file.read(magic_number.data(), magic_number.size())
+        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version))
+        .read(reinterpret_cast<char*>(&num_hashes), sizeof(num_hashes));
+    if (magic_number != BOOT_MAGIC_NUMBER || cache_version != expected_cache_version ||
+        num_hashes > MAX_BOOT_PIPELINES) {
+        return {};
+    }
+    std::vector<u64> hashes(num_hashes);
+    file.read(reinterpret_cast<char*>(hashes.data()), hashes.size() * sizeof(u64));
+    return std::unordered_set<u64>(hashes.begin(), hashes.end());
+
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "{}", e.what());
+    return {};
+}
+
 } // namespace VideoCommon
@@ -8,13 +8,17 @@
 #include <iosfwd>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/mapped_file.h"
 #include "common/polyfill_thread.h"
 #include "common/unique_function.h"
 #include "shader_recompiler/environment.h"
@@ -60,7 +64,7 @@ public:
 
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
-    void Serialize(std::ofstream& file) const;
+    void Serialize(std::ostream& file) const;
 
     bool HasHLEMacroState() const override {
         return has_hle_engine_state;
@@ -165,7 +169,7 @@ public:
     FileEnvironment& operator=(const FileEnvironment&) = delete;
     FileEnvironment(const FileEnvironment&) = delete;
 
-    void Deserialize(std::ifstream& file);
+    void Deserialize(std::istream& file);
 
     [[nodiscard]] u64 ReadInstruction(u32 address) override;
 
@@ -212,21 +216,115 @@ private:
     u32 viewport_transform_state = 1;
 };
 
-void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version);
+/**
+ * Pipeline cache stored on disk.
+ *
+ * Environments are stored once per distinct contents, compressed with zstd, and pipelines refer to
+ * them by hash. New records are appended at the end of the file, and an index of every record is
+ * written after them when the file is closed. The index is cut off before the next records are
+ * appended, so only a single index is kept. Opening the file maps it and reads the index, only the
+ * records appended after the last index are scanned.
+ */
+class PipelineCacheFile {
+public:
+    explicit PipelineCacheFile();
+    ~PipelineCacheFile();
 
-template <typename Key, typename Envs>
-void SerializePipeline(const Key& key, const Envs& envs, const std::filesystem::path& filename,
-                       u32 cache_version) {
-    static_assert(std::is_trivially_copyable_v<Key>);
-    static_assert(std::has_unique_object_representations_v<Key>);
-    SerializePipeline(std::span(reinterpret_cast<const char*>(&key), sizeof(key)),
-                      std::span(envs.data(), envs.size()), filename, cache_version);
-}
+    PipelineCacheFile(const PipelineCacheFile&) = delete;
+    PipelineCacheFile& operator=(const PipelineCacheFile&) = delete;
+
+    /// Opens or creates the cache file, invalid files or files of other versions are discarded.
+    void Open(const std::filesystem::path& filename, u32 cache_version);
+
+    /// Writes the index of the records appended since opening and closes the file.
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const;
+
+    /// Appends a pipeline, environments already present in the file are referenced instead.
+    void Append(std::span<const char> key, std::span<const GenericEnvironment* const> envs);
+
+    template <typename Key, typename Envs>
+    void Append(const Key& key, const Envs& envs) {
+        static_assert(std::is_trivially_copyable_v<Key>);
+        static_assert(std::has_unique_object_representations_v<Key>);
+        Append(std::span(reinterpret_cast<const char*>(&key), sizeof(key)),
+               std::span(envs.data(), envs.size()));
+    }
+
+    /// Returns the environments of the pipeline with the given key, if it's in the file.
+    [[nodiscard]] std::optional<std::vector<FileEnvironment>> Find(std::span<const char> key);
+
+    template <typename Key>
+    [[nodiscard]] std::optional<std::vector<FileEnvironment>> Find(const Key& key) {
+        static_assert(std::is_trivially_copyable_v<Key>);
+        static_assert(std::has_unique_object_representations_v<Key>);
+        return Find(std::span(reinterpret_cast<const char*>(&key), sizeof(key)));
+    }
+
+    /**
+     * Calls load_compute or load_graphics for every pipeline in the file, in insertion order.
+     * Pipelines for which is_deferred returns true are skipped without reading their environments,
+     * they can be fetched later with Find.
+     */
+    void Load(std::stop_token stop_loading,
+              Common::UniqueFunction<void, std::span<const char>, FileEnvironment> load_compute,
+              Common::UniqueFunction<void, std::span<const char>, std::vector<FileEnvironment>>
+                  load_graphics,
+              Common::UniqueFunction<bool, std::span<const char>> is_deferred = {});
+
+private:
+    struct IndexEntry {
+        u64 hash;
+        u64 offset;
+    };
+
+    struct Pipeline {
+        std::vector<char> key;
+        std::vector<u64> env_hashes;
+    };
+
+    void AppendRecords(std::span<const char> key,
+                       std::span<const GenericEnvironment* const> envs);
+
+    bool ReadIndex();
+
+    void WriteIndex();
+
+    /// Removes the index from the end of the file, so the next index takes its place.
+    void DropIndex();
+
+    void CreateFile();
+
+    std::span<const u8> ReadRecord(u64 offset);
+
+    std::optional<Pipeline> ReadPipeline(u64 offset);
+
+    std::optional<Pipeline> FindPipeline(std::span<const char> key, u64 key_hash);
+
+    std::optional<std::vector<FileEnvironment>> ReadEnvironments(std::span<const u64> hashes);
+
+    mutable std::mutex mutex;
+    std::filesystem::path filename;
+    u32 cache_version{};
+    Common::FS::MappedFile mapped_file;
+    Common::FS::IOFile file;
+    std::vector<u8> read_buffer;
+    bool is_index_dirty{};
+    u64 index_offset{}; ///< Offset of the index ending the file, zero when it doesn't end in one
+
+    std::unordered_map<u64, u64> environments;
+    std::vector<IndexEntry> pipelines;
+    std::unordered_multimap<u64, size_t> pipeline_lookup;
+};
+
+/// Stores the hashes of the pipelines used right after booting, so the next boot can build them
+/// before the rest of the pipeline cache.
+void SerializeBootPipelines(std::span<const u64> hashes, const std::filesystem::path& filename,
+                            u32 cache_version);
 
-void LoadPipelines(
-    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics);
+/// Loads the hashes stored by SerializeBootPipelines, the set is empty when there is no record.
+[[nodiscard]] std::unordered_set<u64> LoadBootPipelines(const std::filesystem::path& filename,
+                                                        u32 expected_cache_version);
 
 } // namespace VideoCommon
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/zstd_compression.h"
+#include "video_core/texture_cache/decoded_texture_cache.h"
+#include "video_core/texture_cache/image_info.h"
+
+namespace VideoCommon {
+
+namespace {
+
+constexpr u32 CACHE_MAGIC = 0x43545344; // "DSTC"
+constexpr u32 CACHE_VERSION = 1;
+constexpr size_t MAX_COPIES = 16;
+
+struct EntryHeader {
+    u32 magic;
+    u32 version;
+    u64 converted_size;
+    u64 compressed_size;
+    u32 num_copies;
+    u32 reserved;
+};
+static_assert(std::is_trivially_copyable_v<EntryHeader>);
+static_assert(std::is_trivially_copyable_v<BufferImageCopy>);
+
+bool ParseKey(const std::string& name, DecodedTextureCache::Key& key) {
+    if (name.size() != 32) {
+        return false;
+    }
+    const auto parse = [&](size_t offset, u64& value) {
+        const auto result = std::from_chars(name.data() + offset, name.data() + offset + 16,
+                                            value, 16);
+        return result.ec == std::errc{} && result.ptr == name.data() + offset + 16;
+    };
+    return parse(0, key[1]) && parse(16, key[0]);
+}
+
+} // Anonymous namespace
+
+DecodedTextureCache::DecodedTextureCache() = default;
+
+DecodedTextureCache::~DecodedTextureCache() {
+    writer.WaitForRequests();
+}
+
+void DecodedTextureCache::LoadDiskResources(u64 title_id) {
+    if (title_id == 0) {
+        return;
+    }
+    const auto cache_dir{Common::FS::GetSuyuPath(Common::FS::SuyuPath::CacheDir) / "textures"};
+    const auto title_dir{cache_dir / fmt::format("{:016x}", title_id)};
+    if (!Common::FS::CreateDirs(title_dir)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create decoded texture cache directories");
+        return;
+    }
+
+    std::scoped_lock lock{mutex};
+    base_dir = title_dir;
+    entries.clear();
+    Common::FS::IterateDirEntries(
+        base_dir,
+        [this](const std::filesystem::directory_entry& entry) {
+            if (entry.path().extension() != ".bin") {
+                return true;
+            }
+            Key key;
+            if (ParseKey(entry.path().stem().string(), key)) {
+                entries.insert(key);
+            }
+            return true;
+        },
+        Common::FS::DirEntryFilter::File);
+    is_enabled = true;
+
+    LOG_INFO(HW_GPU, "Loaded {} decoded textures from disk", entries.size());
+}
+
+DecodedTextureCache::Key DecodedTextureCache::MakeKey(std::span<const u8> guest_data,
+                                                      const ImageInfo& info,
+                                                      size_t converted_size) {
+    // Everything that changes the layout or contents of the converted image has to be hashed
+    // together with the guest data.
+    const std::array<u64, 15> layout{
+        CACHE_VERSION,
+        static_cast<u64>(info.format),
+        static_cast<u64>(info.type),
+        static_cast<u64>(info.resources.levels),
+        static_cast<u64>(info.resources.layers),
+        info.size.width,
+        info.size.height,
+        info.size.depth,
+        info.type == ImageType::Linear ? info.pitch : info.block.height,
+        info.type == ImageType::Linear ? 0 : info.block.depth,
+        info.layer_stride,
+        info.tile_width_spacing,
+        converted_size,
+        static_cast<u64>(Settings::values.astc_recompression.GetValue()),
+        static_cast<u64>(Settings::values.bc7_quality.GetValue()),
+    };
+    const u64 layout_hash =
+        Common::CityHash64(reinterpret_cast<const char*>(layout.data()), sizeof(layout));
+    return Common::CityHash128WithSeed(reinterpret_cast<const char*>(guest_data.data()),
+                                       guest_data.size_bytes(), {layout_hash, CACHE_VERSION});
+}
+
+bool DecodedTextureCache::Find(const Key& key, std::span<u8> output,
+                               boost::container::small_vector<BufferImageCopy, 16>& copies) {
+    std::filesystem::path path;
+    {
+        std::scoped_lock lock{mutex};
+        if (!entries.contains(key)) {
+            return false;
+        }
+        path = EntryPath(key);
+    }
+    const auto discard = [&] {
+        LOG_WARNING(HW_GPU, "Discarding invalid decoded texture cache entry {}",
+                    Common::FS::PathToUTF8String(path));
+        std::scoped_lock lock{mutex};
+        entries.erase(key);
+        void(Common::FS::RemoveFile(path));
+        return false;
+    };
+
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    EntryHeader header{};
+    if (!file.IsOpen() || !file.ReadObject(header)) {
+        return discard();
+    }
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+        header.num_copies > MAX_COPIES || header.converted_size > output.size()) {
+        return discard();
+    }
+    std::array<BufferImageCopy, MAX_COPIES> stored_copies;
+    std::vector<u8> compressed(header.compressed_size);
+    if (file.ReadSpan(std::span(stored_copies.data(), header.num_copies)) != header.num_copies ||
+        file.ReadSpan(std::span(compressed)) != compressed.size()) {
+        return discard();
+    }
+    const std::vector<u8> converted = Common::Compression::DecompressDataZSTD(compressed);
+    if (converted.size() != header.converted_size) {
+        return discard();
+    }
+    std::memcpy(output.data(), converted.data(), converted.size());
+    copies.assign(stored_copies.begin(), stored_copies.begin() + header.num_copies);
+    return true;
+}
+
+void DecodedTextureCache::Store(const Key& key, std::span<const u8> converted,
+                                std::span<const BufferImageCopy> copies) {
+    if (copies.size() > MAX_COPIES) {
+        return;
+    }
+    std::filesystem::path path;
+    {
+        std::scoped_lock lock{mutex};
+        if (entries.contains(key) || !pending_entries.insert(key).second) {
+            return;
+        }
+        path = EntryPath(key);
+    }
+    writer.QueueWork([this, key, path = std::move(path),
+                      data = std::vector<u8>(converted.begin(), converted.end()),
+                      stored_copies = std::vector<BufferImageCopy>(copies.begin(), copies.end())] {
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+        const EntryHeader header{
+            .magic = CACHE_MAGIC,
+            .version = CACHE_VERSION,
+            .converted_size = data.size(),
+            .compressed_size = compressed.size(),
+            .num_copies = static_cast<u32>(stored_copies.size()),
+            .reserved = 0,
+        };
+
+        // Write to a temporary file first, so a partially written entry is never indexed.
+        auto temp_path = path;
+        temp_path += ".tmp";
+        bool success = false;
+        {
+            Common::FS::IOFile file{temp_path, Common::FS::FileAccessMode::Write,
+                                    Common::FS::FileType::BinaryFile};
+            const std::span<const BufferImageCopy> copies_span{stored_copies};
+            const std::span<const u8> compressed_span{compressed};
+            success = file.IsOpen() && file.WriteObject(header) &&
+                      file.WriteSpan(copies_span) == copies_span.size() &&
+                      file.WriteSpan(compressed_span) == compressed_span.size();
+        }
+        success = success && Common::FS::RenameFile(temp_path, path);
+
+        std::scoped_lock lock{mutex};
+        pending_entries.erase(key);
+        if (success) {
+            entries.insert(key);
+        } else {
+            LOG_ERROR(HW_GPU, "Failed to write decoded texture cache entry {}",
+                      Common::FS::PathToUTF8String(path));
+            void(Common::FS::RemoveFile(temp_path));
+        }
+    });
+}
+
+std::filesystem::path DecodedTextureCache::EntryPath(const Key& key) const {
+    return base_dir / fmt::format("{:016x}{:016x}.bin", key[1], key[0]);
+}
+
+} // namespace VideoCommon
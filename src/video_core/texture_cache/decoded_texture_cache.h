@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <unordered_set>
+
+#include <boost/container/small_vector.hpp>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+struct ImageInfo;
+
+/**
+ * Persistent, per-title cache of images converted on the CPU (ASTC and BCn decodes).
+ * Entries are keyed by a hash of the guest data and the image layout, and stored as zstd
+ * compressed blobs next to the copies that describe them.
+ */
+class DecodedTextureCache {
+public:
+    using Key = u128;
+
+    explicit DecodedTextureCache();
+    ~DecodedTextureCache();
+
+    DecodedTextureCache(const DecodedTextureCache&) = delete;
+    DecodedTextureCache& operator=(const DecodedTextureCache&) = delete;
+
+    /// Open the cache directory of a title and index the entries in it
+    void LoadDiskResources(u64 title_id);
+
+    /// Return true when a title has been loaded and lookups can be made
+    [[nodiscard]] bool IsEnabled() const noexcept {
+        return is_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Compute the key of a converted image from its guest data
+    [[nodiscard]] static Key MakeKey(std::span<const u8> guest_data, const ImageInfo& info,
+                                     size_t converted_size);
+
+    /// Read a cached image into output and its copies into copies
+    /// @retval True if the image was found
+    [[nodiscard]] bool Find(const Key& key, std::span<u8> output,
+                            boost::container::small_vector<BufferImageCopy, 16>& copies);
+
+    /// Queue a converted image to be written to disk
+    void Store(const Key& key, std::span<const u8> converted,
+               std::span<const BufferImageCopy> copies);
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return static_cast<size_t>(key[0] ^ key[1]);
+        }
+    };
+
+    [[nodiscard]] std::filesystem::path EntryPath(const Key& key) const;
+
+    std::atomic_bool is_enabled{};
+    std::mutex mutex;
+    std::filesystem::path base_dir;
+    std::unordered_set<Key, KeyHash> entries;
+    std::unordered_set<Key, KeyHash> pending_entries;
+    Common::ThreadWorker writer{1, "TextureCacheWriter"};
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <algorithm>
+
+#include "common/literals.h"
+#include "video_core/texture_cache/eviction_policy.h"
+#include "video_core/texture_cache/image_base.h"
+
+namespace VideoCommon {
+
+using namespace Common::Literals;
+
+u64 EvictionPolicy::Score(const ImageBase& image, u64 frame_tick) noexcept {
+    const u64 size_kib =
+        std::max<u64>(std::max(image.guest_size_bytes, image.converted_size_bytes) / 1_KiB, 1);
+    u64 age = frame_tick > image.last_use_tick ? frame_tick - image.last_use_tick : 0;
+
+    // An image that keeps coming back after similar gaps is likely to be used again soon, unless
+    // it has been unused for well over its usual gap.
+    if (image.reuse_distance != 0 && age < 2 * u64{image.reuse_distance}) {
+        age /= 4;
+    }
+
+    u64 cost = 1;
+    if (True(image.flags & ImageFlagBits::Converted)) {
+        // Loading it back means decoding it again, e.g. ASTC on hosts without native support.
+        cost *= 4;
+    }
+    if (True(image.flags & ImageFlagBits::GpuModified)) {
+        // Render targets have to be downloaded before they can be evicted.
+        cost *= 4;
+    }
+    cost *= 1 + std::min<u64>(image.thrash_count, 7);
+
+    u64 score = size_kib * age / cost;
+    if (True(image.flags & (ImageFlagBits::BadOverlap | ImageFlagBits::Alias))) {
+        score *= 2;
+    }
+    return score;
+}
+
+void EvictionPolicy::RecordUse(ImageBase& image, u64 frame_tick) noexcept {
+    if (frame_tick <= image.last_use_tick) {
+        return;
+    }
+    const u64 distance = std::min<u64>(frame_tick - image.last_use_tick, UINT32_MAX);
+    const u64 average = image.reuse_distance == 0
+                            ? distance
+                            : (3 * u64{image.reuse_distance} + distance) / 4;
+    image.reuse_distance = static_cast<u32>(average);
+    image.last_use_tick = frame_tick;
+}
+
+void EvictionPolicy::RecordEviction(const ImageBase& image, u64 frame_tick) {
+    ++stats.evicted_images;
+    stats.evicted_bytes += image.guest_size_bytes;
+    evictions.insert_or_assign(image.gpu_addr, Eviction{
+                                                   .frame_tick = frame_tick,
+                                                   .size_bytes = image.guest_size_bytes,
+                                                   .thrash_count = image.thrash_count,
+                                               });
+}
+
+bool EvictionPolicy::RecordCreation(ImageBase& image, u64 frame_tick) {
+    const auto it = evictions.find(image.gpu_addr);
+    if (it == evictions.end()) {
+        return false;
+    }
+    const Eviction eviction = it->second;
+    evictions.erase(it);
+    if (eviction.size_bytes != image.guest_size_bytes ||
+        frame_tick - eviction.frame_tick > THRASH_WINDOW_FRAMES) {
+        return false;
+    }
+    image.thrash_count = eviction.thrash_count + 1;
+    ++stats.thrashed_images;
+    stats.thrashed_bytes += image.guest_size_bytes;
+    return true;
+}
+
+void EvictionPolicy::Tick(u64 frame_tick) {
+    if (frame_tick % THRASH_WINDOW_FRAMES != 0) {
+        return;
+    }
+    std::erase_if(evictions, [frame_tick](const auto& pair) {
+        return frame_tick - pair.second.frame_tick > THRASH_WINDOW_FRAMES;
+    });
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <unordered_map>
+
+#include "common/common_types.h"
+#include "common/hash.h"
+
+namespace VideoCommon {
+
+struct ImageBase;
+
+struct GarbageCollectorStats {
+    u64 evicted_images = 0;
+    u64 evicted_bytes = 0;
+    u64 thrashed_images = 0; ///< Images created again shortly after being evicted
+    u64 thrashed_bytes = 0;
+};
+
+/**
+ * Decides which images the texture cache garbage collector evicts first.
+ *
+ * Images are scored by the memory they free and how long they have been unused, against what it
+ * costs to load them back: converted images have to be decoded again, GPU modified ones have to be
+ * downloaded first. Images that keep coming back after similar gaps, and images that were evicted
+ * and recreated shortly after, are scored as likely to be used again.
+ */
+class EvictionPolicy {
+public:
+    /// Number of frames after an eviction in which recreating the image counts as thrashing.
+    static constexpr u64 THRASH_WINDOW_FRAMES = 120;
+
+    /// Returns how worthwhile evicting image is at frame_tick, higher scores are evicted first.
+    [[nodiscard]] static u64 Score(const ImageBase& image, u64 frame_tick) noexcept;
+
+    /// Updates the reuse distance of image, used at frame_tick.
+    static void RecordUse(ImageBase& image, u64 frame_tick) noexcept;
+
+    /// Notes that image was evicted at frame_tick.
+    void RecordEviction(const ImageBase& image, u64 frame_tick);
+
+    /// Checks if image was evicted recently, returns true and counts it as thrash if so.
+    bool RecordCreation(ImageBase& image, u64 frame_tick);
+
+    /// Forgets evictions older than the thrash window.
+    void Tick(u64 frame_tick);
+
+    [[nodiscard]] const GarbageCollectorStats& Stats() const noexcept {
+        return stats;
+    }
+
+private:
+    struct Eviction {
+        u64 frame_tick;
+        u32 size_bytes;
+        u32 thrash_count;
+    };
+
+    std::unordered_map<u64, Eviction, Common::IdentityHash<u64>> evictions;
+    GarbageCollectorStats stats;
+};
+
+} // namespace VideoCommon
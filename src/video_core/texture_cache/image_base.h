@@ -104,6 +104,10 @@ struct ImageBase {
     u64 modification_tick = 0;
     size_t lru_index = SIZE_MAX;
 
+    u64 last_use_tick = 0;  ///< Frame the image was last used in
+    u32 reuse_distance = 0; ///< Average number of frames between uses
+    u32 thrash_count = 0;   ///< Times the image was recreated shortly after being evicted
+
     std::array<u32, MAX_MIP_LEVELS> mip_level_offsets{};
 
     std::vector<ImageViewInfo> image_view_infos;
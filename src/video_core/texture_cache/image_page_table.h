@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <boost/container/small_vector.hpp>
+
+#include "common/common_types.h"
+#include "common/hash.h"
+
+namespace VideoCommon {
+
+/**
+ * Maps the pages of an address space to the ids of the images, or image maps, in them.
+ *
+ * Pages are indexed through a two level table of blocks allocated on first use, so a lookup is
+ * two loads instead of a hash, and range queries walk the entries of a block in order and skip
+ * unallocated blocks whole. Pages past the table, which address spaces don't reach in practice,
+ * live in a hash map.
+ */
+template <typename Id>
+class ImagePageTable {
+public:
+    using Entry = boost::container::small_vector<Id, 4>;
+
+    /// Returns the entry of page, or nullptr if it was never created.
+    [[nodiscard]] Entry* Find(u64 page) {
+        if (page >= MAX_PAGES) [[unlikely]] {
+            const auto it = overflow.find(page);
+            return it != overflow.end() ? &it->second : nullptr;
+        }
+        const u64 block_index = page >> BLOCK_BITS;
+        if (block_index >= blocks.size() || !blocks[block_index]) {
+            return nullptr;
+        }
+        return &(*blocks[block_index])[page & BLOCK_MASK];
+    }
+
+    /// Returns the entry of page, creating it if needed.
+    Entry& operator[](u64 page) {
+        if (page >= MAX_PAGES) [[unlikely]] {
+            return overflow[page];
+        }
+        const u64 block_index = page >> BLOCK_BITS;
+        if (block_index >= blocks.size()) {
+            blocks.resize(block_index + 1);
+        }
+        if (!blocks[block_index]) {
+            blocks[block_index] = std::make_unique<Block>();
+        }
+        return (*blocks[block_index])[page & BLOCK_MASK];
+    }
+
+    /**
+     * Calls func on the non-empty entries of the pages in [first_page, last_page], in page order.
+     * If func returns bool, returning true stops the iteration.
+     */
+    template <typename Func>
+    void ForEachEntry(u64 first_page, u64 last_page, Func&& func) {
+        static constexpr bool RETURNS_BOOL =
+            std::is_same_v<std::invoke_result_t<Func, Entry&>, bool>;
+        const auto call = [&func](Entry& entry) {
+            if constexpr (RETURNS_BOOL) {
+                return func(entry);
+            } else {
+                func(entry);
+                return false;
+            }
+        };
+        u64 page = first_page;
+        const u64 table_end = std::min(last_page + 1, MAX_PAGES);
+        const u64 allocated_end = std::min<u64>(table_end, blocks.size() << BLOCK_BITS);
+        while (page < allocated_end) {
+            const u64 block_index = page >> BLOCK_BITS;
+            const u64 block_end = std::min((block_index + 1) << BLOCK_BITS, allocated_end);
+            if (Block* const block = blocks[block_index].get()) {
+                for (; page < block_end; ++page) {
+                    Entry& entry = (*block)[page & BLOCK_MASK];
+                    if (!entry.empty() && call(entry)) {
+                        return;
+                    }
+                }
+            }
+            page = block_end;
+        }
+        if (overflow.empty()) {
+            return;
+        }
+        for (page = std::max(first_page, MAX_PAGES); page <= last_page; ++page) {
+            const auto it = overflow.find(page);
+            if (it != overflow.end() && !it->second.empty() && call(it->second)) {
+                return;
+            }
+        }
+    }
+
+private:
+    static constexpr u64 BLOCK_BITS = 10;
+    static constexpr u64 BLOCK_MASK = (1ULL << BLOCK_BITS) - 1;
+    static constexpr u64 MAX_PAGES = 1ULL << 28;
+
+    using Block = std::array<Entry, 1ULL << BLOCK_BITS>;
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::unordered_map<u64, Entry, Common::IdentityHash<u64>> overflow;
+};
+
+} // namespace VideoCommon
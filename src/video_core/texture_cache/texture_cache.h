@@ -68,6 +68,13 @@ TextureCache<P>::TextureCache(Runtime& runtime_, Tegra::MaxwellDeviceMemoryManag
         critical_memory = DEFAULT_CRITICAL_MEMORY + 1_GiB;
         minimum_memory = 0;
     }
+
+    // A configured budget replaces the limits derived from the device.
+    if (const u64 vram_budget = Settings::values.vram_budget.GetValue(); vram_budget != 0) {
+        critical_memory = vram_budget * 1_MiB;
+        expected_memory = (critical_memory * 3) / 4;
+        minimum_memory = critical_memory / 2;
+    }
 }
 
 template <class P>
@@ -114,6 +121,7 @@ void TextureCache<P>::RunGarbageCollector() {
         if (True(image.flags & ImageFlagBits::Tracked)) {
             UntrackImage(image, image_id);
         }
+        eviction_policy.RecordEviction(image, frame_tick);
         UnregisterImage(image_id);
         DeleteImage(image_id, image.scale_tick > frame_tick + 5);
         if (total_used_memory < critical_memory) {
@@ -131,14 +139,32 @@ void TextureCache<P>::RunGarbageCollector() {
         return false;
     };
 
+    // Score the oldest images, and evict the ones that are most worth it first.
+    const auto Collect = [&] {
+        const size_t max_candidates = num_iterations * 4;
+        gc_candidates.clear();
+        lru_cache.ForEachItemBelow(frame_tick - ticks_to_destroy, [&](ImageId image_id) {
+            const u64 score = EvictionPolicy::Score(slot_images[image_id], frame_tick);
+            gc_candidates.emplace_back(score, image_id);
+            return gc_candidates.size() >= max_candidates;
+        });
+        std::ranges::stable_sort(gc_candidates, std::ranges::greater{},
+                                 &std::pair<u64, ImageId>::first);
+        for (const auto& [score, image_id] : gc_candidates) {
+            if (Cleanup(image_id)) {
+                break;
+            }
+        }
+    };
+
     // Try to remove anything old enough and not high priority.
     Configure(false);
-    lru_cache.ForEachItemBelow(frame_tick - ticks_to_destroy, Cleanup);
+    Collect();
 
     // If pressure is still too high, prune aggressively.
     if (total_used_memory >= critical_memory) {
         Configure(true);
-        lru_cache.ForEachItemBelow(frame_tick - ticks_to_destroy, Cleanup);
+        Collect();
     }
 }
 
@@ -154,6 +180,7 @@ void TextureCache<P>::TickFrame() {
     sentenced_images.Tick();
     sentenced_framebuffers.Tick();
     sentenced_image_view.Tick();
+    eviction_policy.Tick(frame_tick);
     TickAsyncDecode();
 
     runtime.TickFrame();
@@ -167,6 +194,11 @@ void TextureCache<P>::TickFrame() {
     }
 }
 
+template <class P>
+void TextureCache<P>::LoadDiskResources(u64 title_id) {
+    decoded_texture_cache.LoadDiskResources(title_id);
+}
+
 template <class P>
 const typename P::ImageView& TextureCache<P>::GetImageView(ImageViewId id) const noexcept {
     return slot_image_views[id];
@@ -732,11 +764,11 @@ template <class P>
 std::pair<typename P::ImageView*, bool> TextureCache<P>::TryFindFramebufferImageView(
     const Tegra::FramebufferConfig& config, DAddr cpu_addr) {
     // TODO: Properly implement this
-    const auto it = page_table.find(cpu_addr >> SUYU_PAGEBITS);
-    if (it == page_table.end()) {
+    const auto* const image_map_ids_ptr = page_table.Find(cpu_addr >> SUYU_PAGEBITS);
+    if (image_map_ids_ptr == nullptr) {
         return {};
     }
-    const auto& image_map_ids = it->second;
+    const auto& image_map_ids = *image_map_ids_ptr;
     boost::container::small_vector<ImageId, 4> valid_image_ids;
     for (const ImageMapId map_id : image_map_ids) {
         const ImageMapView& map = slot_map_views[map_id];
@@ -1087,10 +1119,24 @@ void TextureCache<P>::UploadImageContents(Image& image, StagingBuffer& staging)
         *gpu_memory, gpu_addr, image.guest_size_bytes, &swizzle_data_buffer);
 
     if (True(image.flags & ImageFlagBits::Converted)) {
+        const bool use_decoded_cache = decoded_texture_cache.IsEnabled();
+        const size_t converted_size = MapSizeBytes(image);
+        DecodedTextureCache::Key key{};
+        if (use_decoded_cache) {
+            key = DecodedTextureCache::MakeKey(swizzle_data, image.info, converted_size);
+            boost::container::small_vector<BufferImageCopy, 16> cached_copies;
+            if (decoded_texture_cache.Find(key, mapped_span, cached_copies)) {
+                image.UploadMemory(staging, cached_copies);
+                return;
+            }
+        }
         unswizzle_data_buffer.resize_destructive(image.unswizzled_size_bytes);
         auto copies =
             UnswizzleImage(*gpu_memory, gpu_addr, image.info, swizzle_data, unswizzle_data_buffer);
         ConvertImage(unswizzle_data_buffer, image.info, mapped_span, copies);
+        if (use_decoded_cache) {
+            decoded_texture_cache.Store(key, mapped_span.first(converted_size), copies);
+        }
         image.UploadMemory(staging, copies);
     } else {
         const auto copies =
@@ -1285,23 +1331,39 @@ void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id) {
     auto decode = std::make_unique<AsyncDecodeContext>();
     auto* decode_ptr = decode.get();
     decode->image_id = image_id;
-    async_decodes.push_back(std::move(decode));
 
     static Common::ScratchBuffer<u8> local_unswizzle_data_buffer;
     local_unswizzle_data_buffer.resize_destructive(image.unswizzled_size_bytes);
     Tegra::Memory::GpuGuestMemory<u8, Tegra::Memory::GuestMemoryFlags::UnsafeRead> swizzle_data(
         *gpu_memory, image.gpu_addr, image.guest_size_bytes, &swizzle_data_buffer);
+    const size_t out_size = MapSizeBytes(image);
+
+    const bool use_decoded_cache = decoded_texture_cache.IsEnabled();
+    DecodedTextureCache::Key key{};
+    if (use_decoded_cache) {
+        key = DecodedTextureCache::MakeKey(swizzle_data, image.info, out_size);
+        decode->decoded_data.resize_destructive(out_size);
+        if (decoded_texture_cache.Find(key, decode->decoded_data, decode->copies)) {
+            // The decode is already done, it will be uploaded on the next tick.
+            decode->complete = true;
+            async_decodes.push_back(std::move(decode));
+            return;
+        }
+    }
+    async_decodes.push_back(std::move(decode));
 
     auto copies = UnswizzleImage(*gpu_memory, image.gpu_addr, image.info, swizzle_data,
                                  local_unswizzle_data_buffer);
-    const size_t out_size = MapSizeBytes(image);
 
-    auto func = [out_size, copies, info = image.info,
+    auto func = [this, out_size, copies, info = image.info, use_decoded_cache, key,
                  input = std::move(local_unswizzle_data_buffer),
                  async_decode = decode_ptr]() mutable {
         async_decode->decoded_data.resize_destructive(out_size);
         std::span copies_span{copies.data(), copies.size()};
         ConvertImage(input, info, async_decode->decoded_data, copies_span);
+        if (use_decoded_cache) {
+            decoded_texture_cache.Store(key, async_decode->decoded_data, copies_span);
+        }
 
         // TODO: Do we need this lock?
         std::unique_lock lock{async_decode->mutex};
@@ -1811,16 +1873,9 @@ void TextureCache<P>::ForEachImageInRegion(DAddr cpu_addr, size_t size, Func&& f
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<ImageId, 32> images;
     boost::container::small_vector<ImageMapId, 32> maps;
-    ForEachCPUPage(cpu_addr, size, [this, &images, &maps, cpu_addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const ImageMapId map_id : it->second) {
+    const u64 page_end = (cpu_addr + size - 1) >> SUYU_PAGEBITS;
+    page_table.ForEachEntry(cpu_addr >> SUYU_PAGEBITS, page_end, [&](const auto& map_ids) {
+        for (const ImageMapId map_id : map_ids) {
             ImageMapView& map = slot_map_views[map_id];
             if (map.picked) {
                 continue;
@@ -1868,38 +1923,30 @@ void TextureCache<P>::ForEachImageInRegionGPU(size_t as_id, GPUVAddr gpu_addr, s
         return;
     }
     auto& gpu_page_table = gpu_page_table_storage[*storage_id * 2];
-    ForEachGPUPage(gpu_addr, size,
-                   [this, &gpu_page_table, &images, gpu_addr, size, func](u64 page) {
-                       const auto it = gpu_page_table.find(page);
-                       if (it == gpu_page_table.end()) {
-                           if constexpr (BOOL_BREAK) {
-                               return false;
-                           } else {
-                               return;
-                           }
-                       }
-                       for (const ImageId image_id : it->second) {
-                           Image& image = slot_images[image_id];
-                           if (True(image.flags & ImageFlagBits::Picked)) {
-                               continue;
-                           }
-                           if (!image.OverlapsGPU(gpu_addr, size)) {
-                               continue;
-                           }
-                           image.flags |= ImageFlagBits::Picked;
-                           images.push_back(image_id);
-                           if constexpr (BOOL_BREAK) {
-                               if (func(image_id, image)) {
-                                   return true;
-                               }
-                           } else {
-                               func(image_id, image);
-                           }
-                       }
-                       if constexpr (BOOL_BREAK) {
-                           return false;
-                       }
-                   });
+    const u64 page_end = (gpu_addr + size - 1) >> SUYU_PAGEBITS;
+    gpu_page_table.ForEachEntry(gpu_addr >> SUYU_PAGEBITS, page_end, [&](const auto& image_ids) {
+        for (const ImageId image_id : image_ids) {
+            Image& image = slot_images[image_id];
+            if (True(image.flags & ImageFlagBits::Picked)) {
+                continue;
+            }
+            if (!image.OverlapsGPU(gpu_addr, size)) {
+                continue;
+            }
+            image.flags |= ImageFlagBits::Picked;
+            images.push_back(image_id);
+            if constexpr (BOOL_BREAK) {
+                if (func(image_id, image)) {
+                    return true;
+                }
+            } else {
+                func(image_id, image);
+            }
+        }
+        if constexpr (BOOL_BREAK) {
+            return false;
+        }
+    });
     for (const ImageId image_id : images) {
         slot_images[image_id].flags &= ~ImageFlagBits::Picked;
     }
@@ -1917,38 +1964,30 @@ void TextureCache<P>::ForEachSparseImageInRegion(size_t as_id, GPUVAddr gpu_addr
         return;
     }
     auto& sparse_page_table = gpu_page_table_storage[*storage_id * 2 + 1];
-    ForEachGPUPage(gpu_addr, size,
-                   [this, &sparse_page_table, &images, gpu_addr, size, func](u64 page) {
-                       const auto it = sparse_page_table.find(page);
-                       if (it == sparse_page_table.end()) {
-                           if constexpr (BOOL_BREAK) {
-                               return false;
-                           } else {
-                               return;
-                           }
-                       }
-                       for (const ImageId image_id : it->second) {
-                           Image& image = slot_images[image_id];
-                           if (True(image.flags & ImageFlagBits::Picked)) {
-                               continue;
-                           }
-                           if (!image.OverlapsGPU(gpu_addr, size)) {
-                               continue;
-                           }
-                           image.flags |= ImageFlagBits::Picked;
-                           images.push_back(image_id);
-                           if constexpr (BOOL_BREAK) {
-                               if (func(image_id, image)) {
-                                   return true;
-                               }
-                           } else {
-                               func(image_id, image);
-                           }
-                       }
-                       if constexpr (BOOL_BREAK) {
-                           return false;
-                       }
-                   });
+    const u64 page_end = (gpu_addr + size - 1) >> SUYU_PAGEBITS;
+    sparse_page_table.ForEachEntry(gpu_addr >> SUYU_PAGEBITS, page_end, [&](const auto& image_ids) {
+        for (const ImageId image_id : image_ids) {
+            Image& image = slot_images[image_id];
+            if (True(image.flags & ImageFlagBits::Picked)) {
+                continue;
+            }
+            if (!image.OverlapsGPU(gpu_addr, size)) {
+                continue;
+            }
+            image.flags |= ImageFlagBits::Picked;
+            images.push_back(image_id);
+            if constexpr (BOOL_BREAK) {
+                if (func(image_id, image)) {
+                    return true;
+                }
+            } else {
+                func(image_id, image);
+            }
+        }
+        if constexpr (BOOL_BREAK) {
+            return false;
+        }
+    });
     for (const ImageId image_id : images) {
         slot_images[image_id].flags &= ~ImageFlagBits::Picked;
     }
@@ -1999,6 +2038,11 @@ void TextureCache<P>::RegisterImage(ImageId image_id) {
     }
     total_used_memory += Common::AlignUp(tentative_size, 1024);
     image.lru_index = lru_cache.Insert(image_id, frame_tick);
+    image.last_use_tick = frame_tick;
+    if (eviction_policy.RecordCreation(image, frame_tick)) {
+        LOG_DEBUG(HW_GPU, "Image at 0x{:x} recreated after eviction, {} images thrashed so far",
+                  image.gpu_addr, eviction_policy.Stats().thrashed_images);
+    }
 
     ForEachGPUPage(image.gpu_addr, image.guest_size_bytes, [this, image_id](u64 page) {
         (*channel_state->gpu_page_table)[page].push_back(image_id);
@@ -2033,36 +2077,33 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
     image.flags &= ~ImageFlagBits::Registered;
     image.flags &= ~ImageFlagBits::BadOverlap;
     lru_cache.Free(image.lru_index);
-    const auto& clear_page_table =
-        [image_id](u64 page,
-                   std::unordered_map<u64, std::vector<ImageId>, Common::IdentityHash<u64>>&
-                       selected_page_table) {
-            const auto page_it = selected_page_table.find(page);
-            if (page_it == selected_page_table.end()) {
-                ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << SUYU_PAGEBITS);
-                return;
-            }
-            std::vector<ImageId>& image_ids = page_it->second;
-            const auto vector_it = std::ranges::find(image_ids, image_id);
-            if (vector_it == image_ids.end()) {
-                ASSERT_MSG(false, "Unregistering unregistered image in page=0x{:x}",
-                           page << SUYU_PAGEBITS);
-                return;
-            }
-            image_ids.erase(vector_it);
-        };
+    const auto& clear_page_table = [image_id](u64 page, TextureCacheGPUMap& selected_page_table) {
+        auto* const image_ids_ptr = selected_page_table.Find(page);
+        if (image_ids_ptr == nullptr) {
+            ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << SUYU_PAGEBITS);
+            return;
+        }
+        auto& image_ids = *image_ids_ptr;
+        const auto vector_it = std::ranges::find(image_ids, image_id);
+        if (vector_it == image_ids.end()) {
+            ASSERT_MSG(false, "Unregistering unregistered image in page=0x{:x}",
+                       page << SUYU_PAGEBITS);
+            return;
+        }
+        image_ids.erase(vector_it);
+    };
     ForEachGPUPage(image.gpu_addr, image.guest_size_bytes, [this, &clear_page_table](u64 page) {
         clear_page_table(page, (*channel_state->gpu_page_table));
     });
     if (False(image.flags & ImageFlagBits::Sparse)) {
         const auto map_id = image.map_view_id;
         ForEachCPUPage(image.cpu_addr, image.guest_size_bytes, [this, map_id](u64 page) {
-            const auto page_it = page_table.find(page);
-            if (page_it == page_table.end()) {
+            auto* const image_map_ids_ptr = page_table.Find(page);
+            if (image_map_ids_ptr == nullptr) {
                 ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << SUYU_PAGEBITS);
                 return;
             }
-            std::vector<ImageMapId>& image_map_ids = page_it->second;
+            auto& image_map_ids = *image_map_ids_ptr;
             const auto vector_it = std::ranges::find(image_map_ids, map_id);
             if (vector_it == image_map_ids.end()) {
                 ASSERT_MSG(false, "Unregistering unregistered image in page=0x{:x}",
@@ -2085,12 +2126,12 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
         const DAddr cpu_addr = map_range.cpu_addr;
         const std::size_t size = map_range.size;
         ForEachCPUPage(cpu_addr, size, [this, image_id](u64 page) {
-            const auto page_it = page_table.find(page);
-            if (page_it == page_table.end()) {
+            auto* const image_map_ids_ptr = page_table.Find(page);
+            if (image_map_ids_ptr == nullptr) {
                 ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << SUYU_PAGEBITS);
                 return;
             }
-            std::vector<ImageMapId>& image_map_ids = page_it->second;
+            auto& image_map_ids = *image_map_ids_ptr;
             auto vector_it = image_map_ids.begin();
             while (vector_it != image_map_ids.end()) {
                 ImageMapView& map = slot_map_views[*vector_it];
@@ -2358,6 +2399,7 @@ void TextureCache<P>::PrepareImage(ImageId image_id, bool is_modification, bool
         MarkModification(image);
     }
     lru_cache.Touch(image.lru_index, frame_tick);
+    EvictionPolicy::RecordUse(image, frame_tick);
 }
 
 template <class P>
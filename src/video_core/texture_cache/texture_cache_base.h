@@ -28,8 +28,11 @@
 #include "video_core/delayed_destruction_ring.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/surface.h"
+#include "video_core/texture_cache/decoded_texture_cache.h"
 #include "video_core/texture_cache/descriptor_table.h"
+#include "video_core/texture_cache/eviction_policy.h"
 #include "video_core/texture_cache/image_base.h"
+#include "video_core/texture_cache/image_page_table.h"
 #include "video_core/texture_cache/image_info.h"
 #include "video_core/texture_cache/image_view_base.h"
 #include "video_core/texture_cache/render_targets.h"
@@ -63,7 +66,7 @@ struct AsyncDecodeContext {
     std::atomic_bool complete;
 };
 
-using TextureCacheGPUMap = std::unordered_map<u64, std::vector<ImageId>, Common::IdentityHash<u64>>;
+using TextureCacheGPUMap = ImagePageTable<ImageId>;
 
 class TextureCacheChannelInfo : public ChannelInfo {
 public:
@@ -91,7 +94,7 @@ public:
 
 template <class P>
 class TextureCache : public VideoCommon::ChannelSetupCaches<TextureCacheChannelInfo> {
-    /// Address shift for caching images into a hash table
+    /// Address shift for caching images into the page tables
     static constexpr u64 SUYU_PAGEBITS = 20;
 
     /// Enables debugging features to the texture cache
@@ -134,6 +137,14 @@ public:
     /// Notify the cache that a new frame has been queued
     void TickFrame();
 
+    /// Load the decoded texture cache of a title from disk
+    void LoadDiskResources(u64 title_id);
+
+    /// Return the eviction and thrash counters of the garbage collector
+    [[nodiscard]] const GarbageCollectorStats& GetGarbageCollectorStats() const noexcept {
+        return eviction_policy.Stats();
+    }
+
     /// Return a constant reference to the given image view id
     [[nodiscard]] const ImageView& GetImageView(ImageViewId id) const noexcept;
 
@@ -256,7 +267,7 @@ private:
     /// Iterate over all page indices in a range
     template <typename Func>
     static void ForEachCPUPage(DAddr addr, size_t size, Func&& func) {
-        static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result<Func, u64>, bool>;
+        static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result_t<Func, u64>, bool>;
         const u64 page_end = (addr + size - 1) >> SUYU_PAGEBITS;
         for (u64 page = addr >> SUYU_PAGEBITS; page <= page_end; ++page) {
             if constexpr (RETURNS_BOOL) {
@@ -271,7 +282,7 @@ private:
 
     template <typename Func>
     static void ForEachGPUPage(GPUVAddr addr, size_t size, Func&& func) {
-        static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result<Func, u64>, bool>;
+        static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result_t<Func, u64>, bool>;
         const u64 page_end = (addr + size - 1) >> SUYU_PAGEBITS;
         for (u64 page = addr >> SUYU_PAGEBITS; page <= page_end; ++page) {
             if constexpr (RETURNS_BOOL) {
@@ -431,7 +442,7 @@ private:
 
     std::unordered_map<RenderTargets, FramebufferId> framebuffers;
 
-    std::unordered_map<u64, std::vector<ImageMapId>, Common::IdentityHash<u64>> page_table;
+    ImagePageTable<ImageMapId> page_table;
     std::unordered_map<ImageId, boost::container::small_vector<ImageViewId, 16>> sparse_views;
 
     DAddr virtual_invalid_space{};
@@ -475,6 +486,8 @@ private:
         using TickType = u64;
     };
     Common::LeastRecentlyUsedCache<LRUItemParams> lru_cache;
+    EvictionPolicy eviction_policy;
+    std::vector<std::pair<u64, ImageId>> gc_candidates;
 
     static constexpr size_t TICKS_TO_DESTROY = 8;
     DelayedDestructionRing<Image, TICKS_TO_DESTROY> sentenced_images;
@@ -489,6 +502,8 @@ private:
     u64 modification_tick = 0;
     u64 frame_tick = 0;
 
+    DecodedTextureCache decoded_texture_cache;
+
     Common::ThreadWorker texture_decode_worker{1, "TextureDecoder"};
     std::vector<std::unique_ptr<AsyncDecodeContext>> async_decodes;
 
@@ -942,10 +942,7 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
                              BytesPerBlock(PixelFormat::A8B8G8R8_UNORM);
         } else if (astc) {
             // BC1 uses 0.5 bytes per texel
-            // BC3 uses 1 byte per texel
-            const auto compress = recompression_setting == Settings::AstcRecompression::Bc1
-                                      ? Tegra::Texture::BCN::CompressBC1
-                                      : Tegra::Texture::BCN::CompressBC3;
+            // BC3 and BC7 use 1 byte per texel
             const auto bpp_div = recompression_setting == Settings::AstcRecompression::Bc1 ? 2 : 1;
 
             const u32 plane_dim = copy.image_extent.width * copy.image_extent.height;
@@ -959,9 +956,25 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
                 copy.image_subresource.num_layers * copy.image_extent.depth, tile_size.width,
                 tile_size.height, decode_scratch);
 
-            compress(decode_scratch, copy.image_extent.width, copy.image_extent.height,
-                     copy.image_subresource.num_layers * copy.image_extent.depth,
-                     output.subspan(output_offset));
+            const u32 depth = copy.image_subresource.num_layers * copy.image_extent.depth;
+            switch (recompression_setting) {
+            case Settings::AstcRecompression::Bc1:
+                Tegra::Texture::BCN::CompressBC1(decode_scratch, copy.image_extent.width,
+                                                 copy.image_extent.height, depth,
+                                                 output.subspan(output_offset));
+                break;
+            case Settings::AstcRecompression::Bc7:
+                Tegra::Texture::BCN::CompressBC7(decode_scratch, copy.image_extent.width,
+                                                 copy.image_extent.height, depth,
+                                                 output.subspan(output_offset),
+                                                 Settings::values.bc7_quality.GetValue());
+                break;
+            default:
+                Tegra::Texture::BCN::CompressBC3(decode_scratch, copy.image_extent.width,
+                                                 copy.image_extent.height, depth,
+                                                 output.subspan(output_offset));
+                break;
+            }
 
             const u32 aligned_plane_dim = Common::AlignUp(copy.image_extent.width, 4) *
                                           Common::AlignUp(copy.image_extent.height, 4);
@@ -8,6 +8,7 @@
 #include <bit>
 #include <cassert>
 #include <cstring>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -1075,18 +1076,82 @@ static u32 UnquantizeTexelWeight(const IntegerEncodedValue& val) {
     return result;
 }
 
-static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector& weights,
-                                   const TexelWeightParams& params, const u32 blockWidth,
-                                   const u32 blockHeight) {
+// Bilinear infill of the weight grid to the texels of a block (Section C.2.18). It only depends
+// on the block and weight grid dimensions, so it is computed once per grid and reused.
+struct WeightInfill {
+    u32 block_width;
+    u32 block_height;
+    std::array<std::array<u8, 4>, 144> index;
+    std::array<std::array<u8, 4>, 144> factor;
+};
+
+static constexpr u32 MAX_WEIGHT_GRID_SIZE = 12;
+static constexpr u32 NUM_WEIGHT_GRIDS = (MAX_WEIGHT_GRID_SIZE + 1) * (MAX_WEIGHT_GRID_SIZE + 1);
+
+static void BuildWeightInfill(WeightInfill& infill, u32 blockWidth, u32 blockHeight,
+                              u32 gridWidth, u32 gridHeight) {
+    const u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
+    const u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
+    const u32 num_weights = gridWidth * gridHeight;
+
+    infill.block_width = blockWidth;
+    infill.block_height = blockHeight;
+    for (u32 t = 0; t < blockHeight; t++) {
+        for (u32 s = 0; s < blockWidth; s++) {
+            const u32 gs = (Ds * s * (gridWidth - 1) + 32) >> 6;
+            const u32 gt = (Dt * t * (gridHeight - 1) + 32) >> 6;
+
+            const u32 js = gs >> 4;
+            const u32 fs = gs & 0xF;
+
+            const u32 jt = gt >> 4;
+            const u32 ft = gt & 0x0F;
+
+            const u32 w11 = (fs * ft + 8) >> 4;
+            const u32 w10 = ft - w11;
+            const u32 w01 = fs - w11;
+            const u32 w00 = 16 - fs - ft + w11;
+
+            const u32 v0 = js + jt * gridWidth;
+            const std::array<u32, 4> indices{v0, v0 + 1, v0 + gridWidth, v0 + gridWidth + 1};
+            const std::array<u32, 4> factors{w00, w01, w10, w11};
+
+            // Texels outside of the grid contribute nothing.
+            const u32 texel = t * blockWidth + s;
+            for (u32 i = 0; i < 4; i++) {
+                const bool in_grid = indices[i] < num_weights;
+                infill.index[texel][i] = static_cast<u8>(in_grid ? indices[i] : 0);
+                infill.factor[texel][i] = static_cast<u8>(in_grid ? factors[i] : 0);
+            }
+        }
+    }
+}
+
+static const WeightInfill& GetWeightInfill(u32 blockWidth, u32 blockHeight, u32 gridWidth,
+                                           u32 gridHeight) {
+    thread_local std::unique_ptr<std::array<WeightInfill, NUM_WEIGHT_GRIDS>> infills;
+    if (!infills) {
+        infills = std::make_unique<std::array<WeightInfill, NUM_WEIGHT_GRIDS>>();
+    }
+    WeightInfill& infill = (*infills)[gridHeight * (MAX_WEIGHT_GRID_SIZE + 1) + gridWidth];
+    if (infill.block_width != blockWidth || infill.block_height != blockHeight) {
+        BuildWeightInfill(infill, blockWidth, blockHeight, gridWidth, gridHeight);
+    }
+    return infill;
+}
+
+static void UnquantizeTexelWeights(std::array<std::array<u32, 144>, 2>& out,
+                                   const IntegerEncodedVector& weights,
+                                   const TexelWeightParams& params) {
     u32 weightIdx = 0;
-    u32 unquantized[2][144];
+    out = {};
 
     for (auto itr = weights.begin(); itr != weights.end(); ++itr) {
-        unquantized[0][weightIdx] = UnquantizeTexelWeight(*itr);
+        out[0][weightIdx] = UnquantizeTexelWeight(*itr);
 
         if (params.m_bDualPlane) {
             ++itr;
-            unquantized[1][weightIdx] = UnquantizeTexelWeight(*itr);
+            out[1][weightIdx] = UnquantizeTexelWeight(*itr);
             if (itr == weights.end()) {
                 break;
             }
@@ -1095,52 +1160,59 @@ static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector&
         if (++weightIdx >= (params.m_Width * params.m_Height))
             break;
     }
+}
 
-    // Do infill if necessary (Section C.2.18) ...
-    u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
-    u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
-
-    const u32 kPlaneScale = params.m_bDualPlane ? 2U : 1U;
-    for (u32 plane = 0; plane < kPlaneScale; plane++)
-        for (u32 t = 0; t < blockHeight; t++)
-            for (u32 s = 0; s < blockWidth; s++) {
-                u32 cs = Ds * s;
-                u32 ct = Dt * t;
-
-                u32 gs = (cs * (params.m_Width - 1) + 32) >> 6;
-                u32 gt = (ct * (params.m_Height - 1) + 32) >> 6;
-
-                u32 js = gs >> 4;
-                u32 fs = gs & 0xF;
-
-                u32 jt = gt >> 4;
-                u32 ft = gt & 0x0F;
-
-                u32 w11 = (fs * ft + 8) >> 4;
-                u32 w10 = ft - w11;
-                u32 w01 = fs - w11;
-                u32 w00 = 16 - fs - ft + w11;
-
-                u32 v0 = js + jt * params.m_Width;
-
-#define FIND_TEXEL(tidx, bidx)                                                                     \
-    u32 p##bidx = 0;                                                                               \
-    do {                                                                                           \
-        if ((tidx) < (params.m_Width * params.m_Height)) {                                         \
-            p##bidx = unquantized[plane][(tidx)];                                                  \
-        }                                                                                          \
-    } while (0)
-
-                FIND_TEXEL(v0, 00);
-                FIND_TEXEL(v0 + 1, 01);
-                FIND_TEXEL(v0 + params.m_Width, 10);
-                FIND_TEXEL(v0 + params.m_Width + 1, 11);
+// Do infill if necessary (Section C.2.18) ...
+static void InfillTexelWeights(u32 out[2][144], const DecodedBlock& block, const u32 blockWidth,
+                               const u32 blockHeight) {
+    const WeightInfill& infill =
+        GetWeightInfill(blockWidth, blockHeight, block.grid_width, block.grid_height);
+    const u32 num_texels = blockWidth * blockHeight;
+
+    const u32 kPlaneScale = block.dual_plane ? 2U : 1U;
+    for (u32 plane = 0; plane < kPlaneScale; plane++) {
+        const auto& unquantized = block.weights[plane];
+        for (u32 texel = 0; texel < num_texels; texel++) {
+            const auto& index = infill.index[texel];
+            const auto& factor = infill.factor[texel];
+            out[plane][texel] =
+                (unquantized[index[0]] * factor[0] + unquantized[index[1]] * factor[1] +
+                 unquantized[index[2]] * factor[2] + unquantized[index[3]] * factor[3] + 8) >>
+                4;
+        }
+    }
+}
 
-#undef FIND_TEXEL
+// Interpolates the endpoints of each texel's partition by its weights and packs the result.
+// Each channel is computed for all texels of the block at a time, so the inner loops vectorize.
+template <bool DualPlane, bool SinglePartition>
+static void InterpolateTexels(std::span<u32, 12 * 12> outBuf, u32 numTexels,
+                              const DecodedBlock& block, const u32 (&weights)[2][144]) {
+    u32 C0[4][4];
+    u32 C1[4][4];
+    for (u32 partition = 0; partition < (SinglePartition ? 1U : 4U); partition++) {
+        for (u32 c = 0; c < 4; c++) {
+            C0[partition][c] = ReplicateByteTo16(block.endpoints[partition][0][c]);
+            C1[partition][c] = ReplicateByteTo16(block.endpoints[partition][1][c]);
+        }
+    }
 
-                out[plane][t * blockWidth + s] =
-                    (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
-            }
+    std::array<u32, 144> packed{};
+    for (u32 c = 0; c < 4; c++) {
+        const u32 plane = (DualPlane && ((block.plane_index + 1) & 3) == c) ? 1 : 0;
+        const u32* const channel_weights = weights[plane];
+        // Channels are stored as A, R, G, B and packed as R8G8B8A8.
+        const u32 shift = c == 0 ? 24 : (c - 1) * 8;
+        for (u32 texel = 0; texel < numTexels; texel++) {
+            const u32 partition = SinglePartition ? 0 : block.texel_partitions[texel];
+            const u32 weight = channel_weights[texel];
+            const u32 C = (C0[partition][c] * (64 - weight) + C1[partition][c] * weight + 32) / 64;
+            // Exact integer form of round(255 * C / 65536).
+            const u32 value = (C * 255 + 32768) >> 16;
+            packed[texel] |= value << shift;
+        }
+    }
+    std::copy_n(packed.begin(), numTexels, outBuf.begin());
 }
 
 // Transfers a bit as described in C.2.14
@@ -1419,8 +1491,11 @@ static void FillError(std::span<u32> outBuf, u32 blockWidth, u32 blockHeight) {
     }
 }
 
-static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
-                            const u32 blockHeight, std::span<u32, 12 * 12> outBuf) {
+// Decodes the endpoints and weights of a block. Void extent and invalid blocks are written to
+// outBuf directly, in which case there is nothing left to interpolate and false is returned.
+static bool DecodeBlockImpl(std::span<const u8, 16> inBuf, const u32 blockWidth,
+                            const u32 blockHeight, std::span<u32, 12 * 12> outBuf,
+                            DecodedBlock& block) {
     InputBitStream strm(inBuf);
     TexelWeightParams weightParams = DecodeBlockInfo(strm);
 
@@ -1428,30 +1503,30 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
     if (weightParams.m_bError) {
         assert(false && "Invalid block mode");
         FillError(outBuf, blockWidth, blockHeight);
-        return;
+        return false;
     }
 
     if (weightParams.m_bVoidExtentLDR) {
         FillVoidExtentLDR(strm, outBuf, blockWidth, blockHeight);
-        return;
+        return false;
     }
 
     if (weightParams.m_bVoidExtentHDR) {
         assert(false && "HDR void extent blocks are unsupported!");
         FillError(outBuf, blockWidth, blockHeight);
-        return;
+        return false;
     }
 
     if (weightParams.m_Width > blockWidth) {
         assert(false && "Texel weight grid width should be smaller than block width");
         FillError(outBuf, blockWidth, blockHeight);
-        return;
+        return false;
     }
 
     if (weightParams.m_Height > blockHeight) {
         assert(false && "Texel weight grid height should be smaller than block height");
         FillError(outBuf, blockWidth, blockHeight);
-        return;
+        return false;
     }
 
     // Read num partitions
@@ -1461,7 +1536,7 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
     if (nPartitions == 4 && weightParams.m_bDualPlane) {
         assert(false && "Dual plane mode is incompatible with four partition blocks");
         FillError(outBuf, blockWidth, blockHeight);
-        return;
+        return false;
     }
 
     // Based on the number of partitions, read the color endpoint mode for
@@ -1613,42 +1688,64 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
     DecodeIntegerSequence(texelWeightValues, weightStream, weightParams.m_MaxWeight,
                           weightParams.GetNumWeightValues());
 
+    UnquantizeTexelWeights(block.weights, texelWeightValues, weightParams);
+
+    for (u32 i = 0; i < nPartitions; i++) {
+        for (u32 e = 0; e < 2; e++) {
+            for (u32 c = 0; c < 4; c++) {
+                block.endpoints[i][e][c] = static_cast<u8>(endpoints[i][e].Component(c));
+            }
+        }
+    }
+    if (nPartitions > 1) {
+        for (u32 j = 0; j < blockHeight; j++) {
+            for (u32 i = 0; i < blockWidth; i++) {
+                const u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions,
+                                                        (blockHeight * blockWidth) < 32);
+                assert(partition < nPartitions);
+                block.texel_partitions[j * blockWidth + i] = static_cast<u8>(partition);
+            }
+        }
+    }
+    block.grid_width = weightParams.m_Width;
+    block.grid_height = weightParams.m_Height;
+    block.num_partitions = nPartitions;
+    block.plane_index = planeIdx;
+    block.dual_plane = weightParams.m_bDualPlane;
+    return true;
+}
+
+bool DecodeBlock(std::span<const uint8_t, 16> data, uint32_t block_width, uint32_t block_height,
+                 DecodedBlock& block) {
+    std::array<u32, 12 * 12> discarded;
+    return DecodeBlockImpl(data, block_width, block_height, discarded, block);
+}
+
+void DecompressBlock(std::span<const uint8_t, 16> data, uint32_t block_width,
+                     uint32_t block_height, std::span<uint32_t, 12 * 12> output) {
+    DecodedBlock block;
+    if (!DecodeBlockImpl(data, block_width, block_height, output, block)) {
+        return;
+    }
+
     // Blocks can be at most 12x12, so we can have as many as 144 weights
     u32 weights[2][144];
-    UnquantizeTexelWeights(weights, texelWeightValues, weightParams, blockWidth, blockHeight);
+    InfillTexelWeights(weights, block, block_width, block_height);
 
     // Now that we have endpoints and weights, we can interpolate and generate
     // the proper decoding...
-    for (u32 j = 0; j < blockHeight; j++)
-        for (u32 i = 0; i < blockWidth; i++) {
-            u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions,
-                                              (blockHeight * blockWidth) < 32);
-            assert(partition < nPartitions);
-
-            Pixel p;
-            for (u32 c = 0; c < 4; c++) {
-                u32 C0 = endpoints[partition][0].Component(c);
-                C0 = ReplicateByteTo16(C0);
-                u32 C1 = endpoints[partition][1].Component(c);
-                C1 = ReplicateByteTo16(C1);
-
-                u32 plane = 0;
-                if (weightParams.m_bDualPlane && (((planeIdx + 1) & 3) == c)) {
-                    plane = 1;
-                }
-
-                u32 weight = weights[plane][j * blockWidth + i];
-                u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
-                if (C == 65535) {
-                    p.Component(c) = 255;
-                } else {
-                    double Cf = static_cast<double>(C);
-                    p.Component(c) = static_cast<u16>(255.0 * (Cf / 65536.0) + 0.5);
-                }
-            }
-
-            outBuf[j * blockWidth + i] = p.Pack();
+    const u32 numTexels = block_width * block_height;
+    if (block.num_partitions == 1) {
+        if (block.dual_plane) {
+            InterpolateTexels<true, true>(output, numTexels, block, weights);
+        } else {
+            InterpolateTexels<false, true>(output, numTexels, block, weights);
         }
+    } else if (block.dual_plane) {
+        InterpolateTexels<true, false>(output, numTexels, block, weights);
+    } else {
+        InterpolateTexels<false, false>(output, numTexels, block, weights);
+    }
 }
 
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
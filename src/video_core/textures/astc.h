@@ -3,8 +3,37 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <span>
+
 namespace Tegra::Texture::ASTC {
 
+/// Endpoints and weights of a block, after decoding and before they are interpolated to texels.
+struct DecodedBlock {
+    /// Endpoint pair of each partition, channels are stored as A, R, G, B.
+    std::array<std::array<std::array<uint8_t, 4>, 2>, 4> endpoints;
+    /// Unquantized weights of each plane, stored in rows of grid_width.
+    std::array<std::array<uint32_t, 12 * 12>, 2> weights;
+    /// Partition of each texel in rows of block_width, only written for multiple partitions.
+    std::array<uint8_t, 12 * 12> texel_partitions;
+    uint32_t grid_width;
+    uint32_t grid_height;
+    uint32_t num_partitions;
+    /// Channel of the second plane, relative to R, G, B, A.
+    uint32_t plane_index;
+    bool dual_plane;
+};
+
+/// Decodes the endpoints and weights of a block. Returns false for void extent and invalid
+/// blocks, which have nothing to interpolate.
+bool DecodeBlock(std::span<const uint8_t, 16> data, uint32_t block_width, uint32_t block_height,
+                 DecodedBlock& block);
+
+/// Decompresses a single block to R8G8B8A8, texels are stored in rows of block_width.
+void DecompressBlock(std::span<const uint8_t, 16> data, uint32_t block_width,
+                     uint32_t block_height, std::span<uint32_t, 12 * 12> output);
+
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
                 uint32_t block_width, uint32_t block_height, std::span<uint8_t> output);
 
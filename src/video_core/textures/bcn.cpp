@@ -1,14 +1,704 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
 #include <stb_dxt.h>
 #include <string.h>
 #include "common/alignment.h"
+#include "common/settings_enums.h"
 #include "video_core/textures/bcn.h"
 #include "video_core/textures/workers.h"
 
 namespace Tegra::Texture::BCN {
 
+namespace {
+
+struct BC7Mode {
+    u32 num_subsets;
+    u32 partition_bits;
+    u32 color_bits;
+    u32 alpha_bits;
+    u32 endpoint_pbits;
+    u32 shared_pbits;
+    u32 index_bits;
+};
+
+// Modes 4 and 5 store separate color and alpha indices and are not used by the encoder
+constexpr std::array<BC7Mode, 8> BC7_MODES{{
+    {3, 4, 4, 0, 1, 0, 3},
+    {2, 6, 6, 0, 0, 1, 3},
+    {3, 6, 5, 0, 0, 0, 2},
+    {2, 6, 7, 0, 1, 0, 2},
+    {1, 0, 5, 6, 0, 0, 2},
+    {1, 0, 7, 8, 0, 0, 2},
+    {1, 0, 7, 7, 1, 0, 4},
+    {2, 6, 5, 5, 1, 0, 2},
+}};
+
+// Bit N is set when texel N belongs to the second subset
+constexpr std::array<u16, 64> BC7_PARTITIONS_2{
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80,
+    0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000, 0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310,
+    0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c, 0xaaaa,
+    0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc,
+    0x6996, 0xc33c, 0x9966, 0x0660, 0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6,
+    0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+// Bits [2N, 2N + 1] hold the subset of texel N
+constexpr std::array<u32, 64> BC7_PARTITIONS_3{
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0,
+    0x5a5a5050, 0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4,
+    0xa9a59450, 0x2a0a4250, 0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454,
+    0x6a6a4040, 0xa4a45000, 0x1a1a0500, 0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400,
+    0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200, 0xa9a58000, 0x5090a0a8, 0xa8a09050,
+    0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50, 0x500aa550, 0xaaaa4444,
+    0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600, 0xaa444444,
+    0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44,
+    0x2a4a5254,
+};
+
+constexpr std::array<u8, 64> BC7_ANCHORS_2{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8,  2,  2,  8,
+    8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,
+    2,  15, 15, 6,  6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15,
+};
+
+constexpr std::array<u8, 64> BC7_ANCHORS_3A{
+    3, 3,  15, 15, 8, 3,  15, 15, 8, 8, 6, 6,  6, 5,  3, 3,  3,  3,  8,  15, 3,  3,
+    6, 10, 5,  8,  8, 6,  8,  5,  15, 15, 8, 15, 3, 5,  6, 10, 8,  15, 15, 3,  15, 5,
+    15, 15, 15, 15, 3, 15, 5,  5,  5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3,  3,
+};
+
+constexpr std::array<u8, 64> BC7_ANCHORS_3B{
+    15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,
+    15, 8,  3,  15, 6,  10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15,
+    3,  6,  6,  8,  15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+};
+
+constexpr std::array<u32, 4> BC7_WEIGHTS_2{0, 21, 43, 64};
+constexpr std::array<u32, 8> BC7_WEIGHTS_3{0, 9, 18, 27, 37, 46, 55, 64};
+constexpr std::array<u32, 16> BC7_WEIGHTS_4{0, 4, 9, 13, 17, 21, 26, 30,
+                                            34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Effort {
+    u32 partitions_2;      ///< Number of two subset partitions encoded for each mode
+    u32 partitions_3;      ///< Number of three subset partitions encoded for each mode
+    u32 iterations;        ///< Number of least squares endpoint refinements
+    u64 skip_threshold;    ///< Squared block error below which partitioned modes are not tried
+    bool exhaustive_pbits; ///< Evaluate every p-bit combination instead of estimating them
+};
+
+constexpr BC7Effort GetBC7Effort(Settings::Bc7Quality quality) {
+    switch (quality) {
+    case Settings::Bc7Quality::Fast:
+        return {0, 0, 1, 0, false};
+    case Settings::Bc7Quality::Medium:
+        return {1, 0, 1, 16 * 4 * 4, false};
+    case Settings::Bc7Quality::High:
+    default:
+        return {8, 4, 2, 16, true};
+    }
+}
+
+using Texels = std::array<std::array<s32, 4>, 16>;
+using FloatColor = std::array<float, 4>;
+
+struct BC7Subset {
+    std::array<std::array<u32, 4>, 2> endpoints; ///< Quantized endpoints without p-bits
+    std::array<u32, 2> pbits;
+    u64 error;
+};
+
+struct BC7Candidate {
+    u32 mode;
+    u32 partition;
+    std::array<BC7Subset, 3> subsets;
+    std::array<u8, 16> indices;
+    u64 error;
+};
+
+u32 GetSubset(const BC7Mode& mode, u32 partition, u32 texel) {
+    switch (mode.num_subsets) {
+    case 2:
+        return (BC7_PARTITIONS_2[partition] >> texel) & 1;
+    case 3:
+        return (BC7_PARTITIONS_3[partition] >> (texel * 2)) & 3;
+    default:
+        return 0;
+    }
+}
+
+u32 GetAnchor(const BC7Mode& mode, u32 partition, u32 subset) {
+    switch (subset) {
+    case 1:
+        return mode.num_subsets == 2 ? BC7_ANCHORS_2[partition] : BC7_ANCHORS_3A[partition];
+    case 2:
+        return BC7_ANCHORS_3B[partition];
+    default:
+        return 0;
+    }
+}
+
+std::span<const u32> GetWeights(u32 index_bits) {
+    switch (index_bits) {
+    case 2:
+        return BC7_WEIGHTS_2;
+    case 3:
+        return BC7_WEIGHTS_3;
+    default:
+        return BC7_WEIGHTS_4;
+    }
+}
+
+/// Expands an endpoint channel of the given precision (including its p-bit) to 8 bits
+u32 Unquantize(u32 value, u32 bits) {
+    value <<= 8 - bits;
+    return value | (value >> bits);
+}
+
+/// Returns the quantized value closest to target, pbit is ignored when has_pbit is false
+u32 QuantizeChannel(float target, u32 bits, bool has_pbit, u32 pbit) {
+    const u32 total_bits = bits + (has_pbit ? 1 : 0);
+    const u32 max_value = (1U << bits) - 1;
+    const float clamped = std::clamp(target, 0.0f, 255.0f);
+    const s32 rounded = static_cast<s32>(clamped + 0.5f);
+    const float scaled = clamped * static_cast<float>((1U << total_bits) - 1) / 255.0f;
+    const s32 guess = static_cast<s32>(has_pbit ? (scaled - static_cast<float>(pbit)) * 0.5f
+                                                : scaled + 0.5f);
+    u32 best_value = 0;
+    s32 best_error = std::numeric_limits<s32>::max();
+    for (s32 value = guess - 1; value <= guess + 1; ++value) {
+        if (value < 0 || value > static_cast<s32>(max_value)) {
+            continue;
+        }
+        const u32 full = has_pbit ? (static_cast<u32>(value) << 1) | pbit : value;
+        const s32 error = std::abs(static_cast<s32>(Unquantize(full, total_bits)) - rounded);
+        if (error < best_error) {
+            best_error = error;
+            best_value = static_cast<u32>(value);
+        }
+    }
+    return best_value;
+}
+
+/// Returns the 8-bit endpoint the decoder reconstructs for a quantized subset
+std::array<std::array<u32, 4>, 2> ExpandEndpoints(const BC7Mode& mode, const BC7Subset& subset) {
+    std::array<std::array<u32, 4>, 2> result;
+    for (u32 e = 0; e < 2; ++e) {
+        const u32 pbit = mode.endpoint_pbits ? subset.pbits[e] : subset.pbits[0];
+        const bool has_pbit = mode.endpoint_pbits || mode.shared_pbits;
+        for (u32 c = 0; c < 3; ++c) {
+            const u32 value = subset.endpoints[e][c];
+            result[e][c] = has_pbit ? Unquantize((value << 1) | pbit, mode.color_bits + 1)
+                                    : Unquantize(value, mode.color_bits);
+        }
+        if (mode.alpha_bits == 0) {
+            result[e][3] = 255;
+        } else {
+            const u32 value = subset.endpoints[e][3];
+            result[e][3] = mode.endpoint_pbits
+                               ? Unquantize((value << 1) | pbit, mode.alpha_bits + 1)
+                               : Unquantize(value, mode.alpha_bits);
+        }
+    }
+    return result;
+}
+
+/// Picks the closest palette entry for every texel of a subset and returns the total error
+u64 AssignIndices(const BC7Mode& mode, const BC7Subset& subset, const Texels& texels,
+                  std::span<const u32> members, std::array<u8, 16>& indices) {
+    const auto weights = GetWeights(mode.index_bits);
+    const auto endpoints = ExpandEndpoints(mode, subset);
+    std::array<std::array<s32, 4>, 16> palette;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        for (u32 c = 0; c < 4; ++c) {
+            palette[i][c] = static_cast<s32>(
+                ((64 - weights[i]) * endpoints[0][c] + weights[i] * endpoints[1][c] + 32) >> 6);
+        }
+    }
+    u64 total_error = 0;
+    for (const u32 texel : members) {
+        u32 best_index = 0;
+        u32 best_error = std::numeric_limits<u32>::max();
+        for (u32 i = 0; i < weights.size(); ++i) {
+            u32 error = 0;
+            for (u32 c = 0; c < 4; ++c) {
+                const s32 delta = texels[texel][c] - palette[i][c];
+                error += static_cast<u32>(delta * delta);
+            }
+            if (error < best_error) {
+                best_error = error;
+                best_index = i;
+            }
+        }
+        indices[texel] = static_cast<u8>(best_index);
+        total_error += best_error;
+    }
+    return total_error;
+}
+
+/// Quantizes a pair of endpoints, choosing p-bits either by endpoint distance or exhaustively
+u64 QuantizeSubset(const BC7Mode& mode, const std::array<FloatColor, 2>& endpoints,
+                   const Texels& texels, std::span<const u32> members, bool exhaustive_pbits,
+                   BC7Subset& subset, std::array<u8, 16>& indices) {
+    const auto quantize = [&](BC7Subset& result, u32 pbit0, u32 pbit1) {
+        const bool has_pbit = mode.endpoint_pbits || mode.shared_pbits;
+        result.pbits = {pbit0, pbit1};
+        for (u32 e = 0; e < 2; ++e) {
+            const u32 pbit = mode.endpoint_pbits ? result.pbits[e] : pbit0;
+            for (u32 c = 0; c < 3; ++c) {
+                result.endpoints[e][c] =
+                    QuantizeChannel(endpoints[e][c], mode.color_bits, has_pbit, pbit);
+            }
+            result.endpoints[e][3] =
+                mode.alpha_bits == 0
+                    ? 0
+                    : QuantizeChannel(endpoints[e][3], mode.alpha_bits, mode.endpoint_pbits != 0,
+                                      pbit);
+        }
+    };
+    const auto endpoint_error = [&](const BC7Subset& result) {
+        const auto expanded = ExpandEndpoints(mode, result);
+        float error = 0.0f;
+        for (u32 e = 0; e < 2; ++e) {
+            for (u32 c = 0; c < 4; ++c) {
+                const float delta = endpoints[e][c] - static_cast<float>(expanded[e][c]);
+                error += delta * delta;
+            }
+        }
+        return error;
+    };
+
+    const u32 num_combinations = mode.endpoint_pbits ? 4 : (mode.shared_pbits ? 2 : 1);
+    if (!exhaustive_pbits && num_combinations > 1) {
+        // Estimate the p-bits from how close the quantized endpoints land to the ideal ones
+        float best_error = std::numeric_limits<float>::max();
+        BC7Subset candidate{};
+        for (u32 combination = 0; combination < num_combinations; ++combination) {
+            const u32 pbit0 = combination & 1;
+            const u32 pbit1 = mode.endpoint_pbits ? combination >> 1 : pbit0;
+            quantize(candidate, pbit0, pbit1);
+            const float error = endpoint_error(candidate);
+            if (error < best_error) {
+                best_error = error;
+                subset = candidate;
+            }
+        }
+        subset.error = AssignIndices(mode, subset, texels, members, indices);
+        return subset.error;
+    }
+    subset.error = std::numeric_limits<u64>::max();
+    std::array<u8, 16> candidate_indices{};
+    BC7Subset candidate{};
+    for (u32 combination = 0; combination < num_combinations; ++combination) {
+        const u32 pbit0 = combination & 1;
+        const u32 pbit1 = mode.endpoint_pbits ? combination >> 1 : pbit0;
+        quantize(candidate, pbit0, pbit1);
+        candidate.error = AssignIndices(mode, candidate, texels, members, candidate_indices);
+        if (candidate.error < subset.error) {
+            subset = candidate;
+            for (const u32 texel : members) {
+                indices[texel] = candidate_indices[texel];
+            }
+        }
+    }
+    return subset.error;
+}
+
+/// Computes the mean and the principal axis of a set of texels
+void FitLine(const Texels& texels, std::span<const u32> members, FloatColor& mean,
+             FloatColor& axis) {
+    mean = {};
+    for (const u32 texel : members) {
+        for (u32 c = 0; c < 4; ++c) {
+            mean[c] += static_cast<float>(texels[texel][c]);
+        }
+    }
+    for (u32 c = 0; c < 4; ++c) {
+        mean[c] /= static_cast<float>(members.size());
+    }
+    std::array<std::array<float, 4>, 4> covariance{};
+    for (const u32 texel : members) {
+        FloatColor delta;
+        for (u32 c = 0; c < 4; ++c) {
+            delta[c] = static_cast<float>(texels[texel][c]) - mean[c];
+        }
+        for (u32 i = 0; i < 4; ++i) {
+            for (u32 j = 0; j < 4; ++j) {
+                covariance[i][j] += delta[i] * delta[j];
+            }
+        }
+    }
+    // Power iteration starting from the channel with the largest variance
+    u32 largest = 0;
+    for (u32 c = 1; c < 4; ++c) {
+        if (covariance[c][c] > covariance[largest][largest]) {
+            largest = c;
+        }
+    }
+    axis = covariance[largest];
+    for (u32 iteration = 0; iteration < 8; ++iteration) {
+        FloatColor next{};
+        for (u32 i = 0; i < 4; ++i) {
+            for (u32 j = 0; j < 4; ++j) {
+                next[i] += covariance[i][j] * axis[j];
+            }
+        }
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] +
+                                       next[2] * next[2] + next[3] * next[3]);
+        if (length < 1e-6f) {
+            break;
+        }
+        for (u32 c = 0; c < 4; ++c) {
+            axis[c] = next[c] / length;
+        }
+    }
+    const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] +
+                                   axis[3] * axis[3]);
+    if (length < 1e-6f) {
+        axis = {};
+        return;
+    }
+    for (u32 c = 0; c < 4; ++c) {
+        axis[c] /= length;
+    }
+}
+
+/// Channel sums and pairwise channel products of a set of texels
+struct TexelMoments {
+    std::array<float, 4> sums{};
+    std::array<float, 10> products{};
+    float count{};
+
+    void Add(const std::array<s32, 4>& texel) {
+        u32 product = 0;
+        for (u32 i = 0; i < 4; ++i) {
+            sums[i] += static_cast<float>(texel[i]);
+            for (u32 j = i; j < 4; ++j) {
+                products[product++] += static_cast<float>(texel[i] * texel[j]);
+            }
+        }
+        count += 1.0f;
+    }
+
+    void Add(const TexelMoments& other) {
+        for (u32 i = 0; i < 4; ++i) {
+            sums[i] += other.sums[i];
+        }
+        for (u32 i = 0; i < 10; ++i) {
+            products[i] += other.products[i];
+        }
+        count += other.count;
+    }
+
+    /// Returns the squared distance of the texels to their best fit line
+    float LineError() const {
+        if (count == 0.0f) {
+            return 0.0f;
+        }
+        std::array<std::array<float, 4>, 4> covariance;
+        u32 product = 0;
+        for (u32 i = 0; i < 4; ++i) {
+            for (u32 j = i; j < 4; ++j) {
+                const float value = products[product++] - sums[i] * sums[j] / count;
+                covariance[i][j] = value;
+                covariance[j][i] = value;
+            }
+        }
+        const float trace = covariance[0][0] + covariance[1][1] + covariance[2][2] +
+                            covariance[3][3];
+        u32 largest = 0;
+        for (u32 c = 1; c < 4; ++c) {
+            if (covariance[c][c] > covariance[largest][largest]) {
+                largest = c;
+            }
+        }
+        // A few power iterations are enough to rank partitions against each other
+        FloatColor axis = covariance[largest];
+        float eigenvalue = 0.0f;
+        for (u32 iteration = 0; iteration < 2; ++iteration) {
+            FloatColor next{};
+            for (u32 i = 0; i < 4; ++i) {
+                for (u32 j = 0; j < 4; ++j) {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+            }
+            const float length_squared =
+                next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3];
+            if (length_squared < 1e-12f) {
+                return trace;
+            }
+            const float axis_squared =
+                axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+            eigenvalue = std::sqrt(length_squared / axis_squared);
+            axis = next;
+        }
+        return std::max(trace - eigenvalue, 0.0f);
+    }
+};
+
+/// Finds endpoints for a subset and refines them with least squares passes
+u64 EncodeSubset(const BC7Mode& mode, const Texels& texels, std::span<const u32> members,
+                 const BC7Effort& effort, BC7Subset& subset, std::array<u8, 16>& indices) {
+    FloatColor mean;
+    FloatColor axis;
+    FitLine(texels, members, mean, axis);
+    float min_t = 0.0f;
+    float max_t = 0.0f;
+    for (const u32 texel : members) {
+        float t = 0.0f;
+        for (u32 c = 0; c < 4; ++c) {
+            t += (static_cast<float>(texels[texel][c]) - mean[c]) * axis[c];
+        }
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+    std::array<FloatColor, 2> endpoints;
+    for (u32 c = 0; c < 4; ++c) {
+        endpoints[0][c] = mean[c] + axis[c] * min_t;
+        endpoints[1][c] = mean[c] + axis[c] * max_t;
+    }
+    u64 best_error = QuantizeSubset(mode, endpoints, texels, members, effort.exhaustive_pbits,
+                                    subset, indices);
+
+    const auto weights = GetWeights(mode.index_bits);
+    std::array<u8, 16> candidate_indices = indices;
+    for (u32 iteration = 0; iteration < effort.iterations && best_error > 0; ++iteration) {
+        // Solve for the endpoints that best reproduce the texels with the current indices
+        float aa = 0.0f;
+        float ab = 0.0f;
+        float bb = 0.0f;
+        FloatColor ax{};
+        FloatColor bx{};
+        for (const u32 texel : members) {
+            const float w = static_cast<float>(weights[candidate_indices[texel]]) / 64.0f;
+            aa += (1.0f - w) * (1.0f - w);
+            ab += (1.0f - w) * w;
+            bb += w * w;
+            for (u32 c = 0; c < 4; ++c) {
+                ax[c] += (1.0f - w) * static_cast<float>(texels[texel][c]);
+                bx[c] += w * static_cast<float>(texels[texel][c]);
+            }
+        }
+        const float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f) {
+            break;
+        }
+        for (u32 c = 0; c < 4; ++c) {
+            endpoints[0][c] = (bb * ax[c] - ab * bx[c]) / determinant;
+            endpoints[1][c] = (aa * bx[c] - ab * ax[c]) / determinant;
+        }
+        BC7Subset candidate;
+        const u64 error = QuantizeSubset(mode, endpoints, texels, members,
+                                         effort.exhaustive_pbits, candidate, candidate_indices);
+        if (error >= best_error) {
+            break;
+        }
+        best_error = error;
+        subset = candidate;
+        for (const u32 texel : members) {
+            indices[texel] = candidate_indices[texel];
+        }
+    }
+    return best_error;
+}
+
+void EncodeMode(u32 mode_index, u32 partition, const Texels& texels, const BC7Effort& effort,
+                BC7Candidate& best) {
+    const BC7Mode& mode = BC7_MODES[mode_index];
+    BC7Candidate candidate{};
+    candidate.mode = mode_index;
+    candidate.partition = partition;
+    for (u32 s = 0; s < mode.num_subsets; ++s) {
+        std::array<u32, 16> members;
+        size_t num_members = 0;
+        for (u32 texel = 0; texel < 16; ++texel) {
+            if (GetSubset(mode, partition, texel) == s) {
+                members[num_members++] = texel;
+            }
+        }
+        candidate.error += EncodeSubset(mode, texels, std::span(members.data(), num_members),
+                                        effort, candidate.subsets[s], candidate.indices);
+        if (candidate.error >= best.error) {
+            return;
+        }
+    }
+    best = candidate;
+}
+
+/// Returns the partitions of a subset count sorted by how well each subset fits a line
+template <u32 NumSubsets>
+std::array<u8, 64> RankPartitions(const Texels& texels) {
+    const BC7Mode& mode = BC7_MODES[NumSubsets == 2 ? 1 : 2];
+    std::array<TexelMoments, 16> texel_moments{};
+    TexelMoments total{};
+    for (u32 texel = 0; texel < 16; ++texel) {
+        texel_moments[texel].Add(texels[texel]);
+        total.Add(texel_moments[texel]);
+    }
+    std::array<std::pair<float, u8>, 64> scores;
+    for (u32 partition = 0; partition < 64; ++partition) {
+        std::array<TexelMoments, NumSubsets> subsets{};
+        for (u32 texel = 0; texel < 16; ++texel) {
+            const u32 subset = GetSubset(mode, partition, texel);
+            if (subset != 0) {
+                subsets[subset].Add(texel_moments[texel]);
+            }
+        }
+        // The first subset is whatever the others leave out of the whole block
+        subsets[0] = total;
+        for (u32 s = 1; s < NumSubsets; ++s) {
+            for (u32 i = 0; i < 4; ++i) {
+                subsets[0].sums[i] -= subsets[s].sums[i];
+            }
+            for (u32 i = 0; i < 10; ++i) {
+                subsets[0].products[i] -= subsets[s].products[i];
+            }
+            subsets[0].count -= subsets[s].count;
+        }
+        float error = 0.0f;
+        for (const TexelMoments& subset : subsets) {
+            error += subset.LineError();
+        }
+        scores[partition] = {error, static_cast<u8>(partition)};
+    }
+    std::sort(scores.begin(), scores.end());
+    std::array<u8, 64> result;
+    for (u32 i = 0; i < 64; ++i) {
+        result[i] = scores[i].second;
+    }
+    return result;
+}
+
+class BitWriter {
+public:
+    void Write(u64 value, u32 count) {
+        for (u32 i = 0; i < count; ++i, ++position) {
+            const u64 bit = (value >> i) & 1;
+            if (position < 64) {
+                low |= bit << position;
+            } else {
+                high |= bit << (position - 64);
+            }
+        }
+    }
+
+    void Store(u8* output) const {
+        std::memcpy(output, &low, sizeof(low));
+        std::memcpy(output + sizeof(low), &high, sizeof(high));
+    }
+
+private:
+    u64 low{};
+    u64 high{};
+    u32 position{};
+};
+
+void PackBC7(BC7Candidate& block, u8* output) {
+    const BC7Mode& mode = BC7_MODES[block.mode];
+    const u32 max_index = (1U << mode.index_bits) - 1;
+
+    // The most significant bit of each anchor index is implicitly zero, flip subsets that need it
+    for (u32 s = 0; s < mode.num_subsets; ++s) {
+        const u32 anchor = GetAnchor(mode, block.partition, s);
+        if (block.indices[anchor] <= max_index / 2) {
+            continue;
+        }
+        BC7Subset& subset = block.subsets[s];
+        std::swap(subset.endpoints[0], subset.endpoints[1]);
+        if (mode.endpoint_pbits) {
+            std::swap(subset.pbits[0], subset.pbits[1]);
+        }
+        for (u32 texel = 0; texel < 16; ++texel) {
+            if (GetSubset(mode, block.partition, texel) == s) {
+                block.indices[texel] = static_cast<u8>(max_index - block.indices[texel]);
+            }
+        }
+    }
+
+    BitWriter writer;
+    writer.Write(1ULL << block.mode, block.mode + 1);
+    writer.Write(block.partition, mode.partition_bits);
+    for (u32 c = 0; c < 4; ++c) {
+        const u32 bits = c < 3 ? mode.color_bits : mode.alpha_bits;
+        for (u32 s = 0; s < mode.num_subsets; ++s) {
+            writer.Write(block.subsets[s].endpoints[0][c], bits);
+            writer.Write(block.subsets[s].endpoints[1][c], bits);
+        }
+    }
+    if (mode.endpoint_pbits) {
+        for (u32 s = 0; s < mode.num_subsets; ++s) {
+            writer.Write(block.subsets[s].pbits[0], 1);
+            writer.Write(block.subsets[s].pbits[1], 1);
+        }
+    }
+    if (mode.shared_pbits) {
+        for (u32 s = 0; s < mode.num_subsets; ++s) {
+            writer.Write(block.subsets[s].pbits[0], 1);
+        }
+    }
+    for (u32 texel = 0; texel < 16; ++texel) {
+        const u32 subset = GetSubset(mode, block.partition, texel);
+        const bool is_anchor = GetAnchor(mode, block.partition, subset) == texel;
+        writer.Write(block.indices[texel], mode.index_bits - (is_anchor ? 1 : 0));
+    }
+    writer.Store(output);
+}
+
+template <Settings::Bc7Quality Quality>
+void CompressBC7Block(u8* block_output, const u8* block_input, [[maybe_unused]] bool any_alpha) {
+    constexpr BC7Effort effort = GetBC7Effort(Quality);
+    Texels texels;
+    bool is_opaque = true;
+    for (u32 texel = 0; texel < 16; ++texel) {
+        for (u32 c = 0; c < 4; ++c) {
+            texels[texel][c] = block_input[texel * 4 + c];
+        }
+        is_opaque &= block_input[texel * 4 + 3] == 255;
+    }
+
+    BC7Candidate best{};
+    best.error = std::numeric_limits<u64>::max();
+    EncodeMode(6, 0, texels, effort, best);
+
+    if (effort.partitions_2 > 0 && best.error > effort.skip_threshold) {
+        const auto ranking = RankPartitions<2>(texels);
+        for (u32 i = 0; i < effort.partitions_2; ++i) {
+            if (is_opaque) {
+                EncodeMode(1, ranking[i], texels, effort, best);
+                EncodeMode(3, ranking[i], texels, effort, best);
+            } else {
+                EncodeMode(7, ranking[i], texels, effort, best);
+            }
+        }
+    }
+    if (effort.partitions_3 > 0 && is_opaque && best.error > effort.skip_threshold) {
+        const auto ranking = RankPartitions<3>(texels);
+        for (u32 i = 0; i < effort.partitions_3; ++i) {
+            EncodeMode(2, ranking[i], texels, effort, best);
+        }
+        // Mode 0 can only address the first 16 partitions
+        u32 num_encoded = 0;
+        for (u32 i = 0; i < 64 && num_encoded < effort.partitions_3; ++i) {
+            if (ranking[i] < 16) {
+                EncodeMode(0, ranking[i], texels, effort, best);
+                ++num_encoded;
+            }
+        }
+    }
+    PackBC7(best, block_output);
+}
+
+} // Anonymous namespace
+
 using BCNCompressor = void(u8* block_output, const u8* block_input, bool any_alpha);
 
 template <u32 BytesPerBlock, bool ThresholdAlpha = false>
@@ -83,4 +773,23 @@ void CompressBC3(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                            });
 }
 
+void CompressBC7(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
+                 std::span<uint8_t> output, Settings::Bc7Quality quality) {
+    switch (quality) {
+    case Settings::Bc7Quality::Fast:
+        CompressBCN<16, false>(data, width, height, depth, output,
+                               CompressBC7Block<Settings::Bc7Quality::Fast>);
+        break;
+    case Settings::Bc7Quality::Medium:
+        CompressBCN<16, false>(data, width, height, depth, output,
+                               CompressBC7Block<Settings::Bc7Quality::Medium>);
+        break;
+    case Settings::Bc7Quality::High:
+    default:
+        CompressBCN<16, false>(data, width, height, depth, output,
+                               CompressBC7Block<Settings::Bc7Quality::High>);
+        break;
+    }
+}
+
 } // namespace Tegra::Texture::BCN
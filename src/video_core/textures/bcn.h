@@ -6,6 +6,7 @@
 #include <span>
 
 #include "common/common_types.h"
+#include "common/settings_enums.h"
 
 namespace Tegra::Texture::BCN {
 
@@ -13,4 +14,7 @@ void CompressBC1(std::span<const u8> data, u32 width, u32 height, u32 depth, std
 
 void CompressBC3(std::span<const u8> data, u32 width, u32 height, u32 depth, std::span<u8> output);
 
+void CompressBC7(std::span<const u8> data, u32 width, u32 height, u32 depth, std::span<u8> output,
+                 Settings::Bc7Quality quality);
+
 } // namespace Tegra::Texture::BCN
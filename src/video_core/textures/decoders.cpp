@@ -1,20 +1,31 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <span>
+#include <thread>
 
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "common/div_ceil.h"
+#include "common/literals.h"
 #include "video_core/gpu.h"
 #include "video_core/textures/decoders.h"
+#include "video_core/textures/workers.h"
 
 namespace Tegra::Texture {
 namespace {
+using namespace Common::Literals;
+
 template <u32 mask>
 constexpr u32 pdep(u32 value) {
     u32 result = 0;
@@ -33,59 +44,206 @@ void incrpdep(u32& value) {
     value = ((value | ~mask) + swizzled_incr) & mask;
 }
 
-template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
-void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
-                 u32 block_height, u32 block_depth, u32 stride) {
-    // The origin of the transformation can be configured here, leave it as zero as the current API
-    // doesn't expose it.
-    static constexpr u32 origin_x = 0;
-    static constexpr u32 origin_y = 0;
-    static constexpr u32 origin_z = 0;
+/// Block heights above this are not specialized and fall back to the dynamic kernel.
+constexpr u32 MAX_SPECIALIZED_BLOCK_HEIGHT = 5;
+constexpr u32 DYNAMIC_BLOCK_HEIGHT = std::numeric_limits<u32>::max();
 
-    // We can configure here a custom pitch
-    // As it's not exposed 'width * BYTES_PER_PIXEL' will be the expected pitch.
-    const u32 pitch = width * BYTES_PER_PIXEL;
+/// Swizzles smaller than this are done on the calling thread.
+constexpr size_t PARALLEL_SWIZZLE_THRESHOLD = 1_MiB;
+
+/// Parallel swizzles are split in batches of about this size, so every worker gets a few of them.
+constexpr size_t PARALLEL_SWIZZLE_BATCH_SIZE = PARALLEL_SWIZZLE_THRESHOLD / 4;
+
+/// Bytes within a 16 byte sector of a GOB row are contiguous in both layouts.
+constexpr u32 SECTOR_SIZE = 16;
+
+/// Offsets of the four sectors of a GOB row relative to the start of the row.
+constexpr std::array<u32, GOB_SIZE_X / SECTOR_SIZE> GOB_ROW_SECTOR_OFFSETS{0, 32, 256, 288};
+
+template <bool TO_LINEAR, size_t SIZE>
+void CopySector(u8* linear, u8* swizzled) {
+    // Fixed-size copies are lowered to single vector loads and stores on SSE and NEON.
+    if constexpr (TO_LINEAR) {
+        std::memcpy(swizzled, linear, SIZE);
+    } else {
+        std::memcpy(linear, swizzled, SIZE);
+    }
+}
+
+template <bool TO_LINEAR>
+void CopyBytes(u8* linear, u8* swizzled, size_t size) {
+    if constexpr (TO_LINEAR) {
+        std::memcpy(swizzled, linear, size);
+    } else {
+        std::memcpy(linear, swizzled, size);
+    }
+}
+
+/**
+ * Swizzles a range of block rows of a block linear texture.
+ * A block row is a full row of blocks of a slice, 'GOB_SIZE_Y << block_height' lines tall, so
+ * block rows never overlap in either the swizzled or the linear layout.
+ */
+template <bool TO_LINEAR, u32 BLOCK_HEIGHT>
+void SwizzleImpl(u8* linear, u8* swizzled, u32 pitch, u32 height, u32 dynamic_block_height,
+                 u32 block_depth, u32 stride, u32 first_block_row, u32 num_block_rows) {
+    const u32 block_height =
+        BLOCK_HEIGHT == DYNAMIC_BLOCK_HEIGHT ? dynamic_block_height : BLOCK_HEIGHT;
 
     const u32 gobs_in_x = Common::DivCeilLog2(stride, GOB_SIZE_X_SHIFT);
     const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height + block_depth);
-    const u32 slice_size =
-        Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
+    const u32 block_rows_per_slice = Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT);
+    const u32 slice_size = block_rows_per_slice * block_size;
 
     const u32 block_height_mask = (1U << block_height) - 1;
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
+    const u32 lines_per_block = GOB_SIZE_Y << block_height;
+
+    const u32 full_gobs = pitch >> GOB_SIZE_X_SHIFT;
+    const u32 sectors_end = Common::AlignDown(pitch, SECTOR_SIZE);
+
+    for (u32 block_row = first_block_row; block_row < first_block_row + num_block_rows;
+         ++block_row) {
+        const u32 z = block_row / block_rows_per_slice;
+        const u32 first_line = (block_row % block_rows_per_slice) * lines_per_block;
+        const u32 last_line = std::min(height, first_line + lines_per_block);
 
-    for (u32 slice = 0; slice < depth; ++slice) {
-        const u32 z = slice + origin_z;
         const u32 offset_z = (z >> block_depth) * slice_size +
                              ((z & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
-        for (u32 line = 0; line < height; ++line) {
-            const u32 y = line + origin_y;
+        for (u32 y = first_line; y < last_line; ++y) {
             const u32 swizzled_y = pdep<SWIZZLE_Y_BITS>(y);
 
             const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < width;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
+            const u32 swizzled_line = offset_z + offset_y + swizzled_y;
+            u8* const linear_line = linear + (static_cast<size_t>(z) * height + y) * pitch;
+
+            // Copy whole GOB rows, one sector at a time.
+            for (u32 gob = 0; gob < full_gobs; ++gob) {
+                u8* const linear_gob = linear_line + (gob << GOB_SIZE_X_SHIFT);
+                u8* const swizzled_gob = swizzled + swizzled_line + (gob << x_shift);
+                for (u32 sector = 0; sector < GOB_ROW_SECTOR_OFFSETS.size(); ++sector) {
+                    CopySector<TO_LINEAR, SECTOR_SIZE>(linear_gob + sector * SECTOR_SIZE,
+                                                       swizzled_gob +
+                                                           GOB_ROW_SECTOR_OFFSETS[sector]);
+                }
+            }
 
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
+            // Copy the remaining full sectors of a partially covered GOB.
+            u32 x = full_gobs << GOB_SIZE_X_SHIFT;
+            u32 swizzled_x = 0;
+            const u32 offset_x = full_gobs << x_shift;
+            for (; x < sectors_end; x += SECTOR_SIZE) {
+                CopySector<TO_LINEAR, SECTOR_SIZE>(linear_line + x,
+                                                   swizzled + swizzled_line + offset_x +
+                                                       swizzled_x);
+                incrpdep<SWIZZLE_X_BITS, SECTOR_SIZE>(swizzled_x);
+            }
 
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
+            // The tail is shorter than a sector, so it is contiguous in both layouts.
+            if (x < pitch) {
+                CopyBytes<TO_LINEAR>(linear_line + x, swizzled + swizzled_line + offset_x +
+                                                          swizzled_x,
+                                     pitch - x);
+            }
+        }
+    }
+}
 
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
+template <bool TO_LINEAR>
+void SwizzleBlockRows(u8* linear, u8* swizzled, u32 pitch, u32 height, u32 block_height,
+                      u32 block_depth, u32 stride, u32 first_block_row, u32 num_block_rows) {
+    switch (block_height) {
+#define BLOCK_HEIGHT_CASE(x)                                                                       \
+    case x:                                                                                        \
+        return SwizzleImpl<TO_LINEAR, x>(linear, swizzled, pitch, height, block_height,            \
+                                         block_depth, stride, first_block_row, num_block_rows);
+        BLOCK_HEIGHT_CASE(0)
+        BLOCK_HEIGHT_CASE(1)
+        BLOCK_HEIGHT_CASE(2)
+        BLOCK_HEIGHT_CASE(3)
+        BLOCK_HEIGHT_CASE(4)
+        BLOCK_HEIGHT_CASE(5)
+#undef BLOCK_HEIGHT_CASE
+    default:
+        static_assert(MAX_SPECIALIZED_BLOCK_HEIGHT == 5);
+        return SwizzleImpl<TO_LINEAR, DYNAMIC_BLOCK_HEIGHT>(linear, swizzled, pitch, height,
+                                                            block_height, block_depth, stride,
+                                                            first_block_row, num_block_rows);
+    }
+}
 
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
+/**
+ * Runs 'func' for every index in [0, count), sharing the work with the image transcode workers.
+ * The calling thread takes part in the work, so it never waits behind unrelated queued work.
+ */
+template <typename Func>
+void ParallelFor(u32 count, Func&& func) {
+    struct State {
+        std::atomic<u32> next_index{};
+        std::mutex mutex;
+        std::condition_variable cv;
+        u32 done_count{};
+    };
+    const auto state = std::make_shared<State>();
+    const auto run = [state, count, func] {
+        u32 num_done = 0;
+        for (u32 index = state->next_index++; index < count; index = state->next_index++) {
+            func(index);
+            ++num_done;
+        }
+        if (num_done == 0) {
+            return;
+        }
+        std::scoped_lock lk{state->mutex};
+        state->done_count += num_done;
+        if (state->done_count == count) {
+            state->cv.notify_all();
         }
+    };
+
+    Common::ThreadWorker& workers{GetThreadWorkers()};
+    const u32 num_helpers = std::min(count, std::max(std::thread::hardware_concurrency(), 2U) / 2);
+    for (u32 helper = 1; helper < num_helpers; ++helper) {
+        workers.QueueWork(run);
+    }
+    run();
+
+    std::unique_lock lk{state->mutex};
+    state->cv.wait(lk, [&] { return state->done_count == count; });
+}
+
+template <bool TO_LINEAR>
+void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
+             u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
+    // Swizzling happens on bytes, so the pixel size only matters to compute the pitch.
+    const u32 pitch = width * bytes_per_pixel;
+    u8* const linear = const_cast<u8*>(TO_LINEAR ? input.data() : output.data());
+    u8* const swizzled = const_cast<u8*>(TO_LINEAR ? output.data() : input.data());
+
+    const u32 block_rows_per_slice = Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT);
+    const u32 num_block_rows = block_rows_per_slice * depth;
+    const size_t linear_size = static_cast<size_t>(pitch) * height * depth;
+    if (linear_size < PARALLEL_SWIZZLE_THRESHOLD || num_block_rows < 2) {
+        SwizzleBlockRows<TO_LINEAR>(linear, swizzled, pitch, height, block_height, block_depth,
+                                    stride_alignment, 0, num_block_rows);
+        return;
     }
+
+    // Split the texture into batches of whole block rows of roughly the batch size.
+    const size_t block_row_size = linear_size / num_block_rows;
+    const u32 rows_per_batch = static_cast<u32>(
+        std::max<size_t>(1, Common::DivCeil(PARALLEL_SWIZZLE_BATCH_SIZE, block_row_size)));
+    const u32 num_batches = Common::DivCeil(num_block_rows, rows_per_batch);
+    ParallelFor(num_batches, [=](u32 batch) {
+        const u32 first_block_row = batch * rows_per_batch;
+        const u32 batch_rows = std::min(rows_per_batch, num_block_rows - first_block_row);
+        SwizzleBlockRows<TO_LINEAR>(linear, swizzled, pitch, height, block_height, block_depth,
+                                    stride_alignment, first_block_row, batch_rows);
+    });
 }
 
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
@@ -151,29 +309,6 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
     }
 }
 
-template <bool TO_LINEAR>
-void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
-             u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
-    switch (bytes_per_pixel) {
-#define BPP_CASE(x)                                                                                \
-    case x:                                                                                        \
-        return SwizzleImpl<TO_LINEAR, x>(output, input, width, height, depth, block_height,        \
-                                         block_depth, stride_alignment);
-        BPP_CASE(1)
-        BPP_CASE(2)
-        BPP_CASE(3)
-        BPP_CASE(4)
-        BPP_CASE(6)
-        BPP_CASE(8)
-        BPP_CASE(12)
-        BPP_CASE(16)
-#undef BPP_CASE
-    default:
-        ASSERT_MSG(false, "Invalid bytes_per_pixel={}", bytes_per_pixel);
-        break;
-    }
-}
-
 } // Anonymous namespace
 
 void UnswizzleTexture(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel,